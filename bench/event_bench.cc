@@ -0,0 +1,277 @@
+/**
+ * @file event_bench.cc
+ * @brief Event scheduler throughput benchmark.
+ *
+ * Replays the scheduler's access pattern: the first event of every ride is
+ * pushed (Phase 2), then the earliest event is repeatedly popped and its
+ * successor scheduled a random travel time later ("hold" model) until every
+ * ride has reached its last stop (Phase 3). Ride start times follow Poisson
+ * arrivals, steady or with rush-hour peaks, and travel times follow
+ * exponential or heavy-tailed lognormal distributions.
+ *
+ * Each workload is run on a copy of the original binary heap that indexes
+ * through the bounds-checked Vector::operator[], on the binary MinHeap with
+ * pop() and push(), on the 2-, 4- and 8-ary MinHeaps with replace_top() as
+ * the simulation loop does, and on the CalendarQueue. The push throughput of
+ * Phase 2 and the overall event throughput are reported for each. A final
+ * sweep over the number of rides shows where the calendar queue overtakes
+ * the heaps.
+ *
+ * Usage: event_bench.out [rides] [stops_per_ride]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "calendar_queue.h"
+#include "event.h"
+#include "min_heap.h"
+#include "vector.h"
+
+namespace {
+
+/**
+ * @brief The original MinHeap, with every access bounds-checked.
+ */
+template <typename T> class CheckedMinHeap {
+private:
+  Vector<T> heap_;
+
+  void HeapifyUp(size_t index) {
+    if (index == 0)
+      return;
+    size_t parent_index = (index - 1) / 2;
+    if (heap_[index] < heap_[parent_index]) {
+      T temp = heap_[index];
+      heap_[index] = heap_[parent_index];
+      heap_[parent_index] = temp;
+      HeapifyUp(parent_index);
+    }
+  }
+
+  void HeapifyDown(size_t index) {
+    size_t left_child = 2 * index + 1;
+    size_t right_child = 2 * index + 2;
+    size_t smallest = index;
+    if (left_child < heap_.size() && heap_[left_child] < heap_[smallest]) {
+      smallest = left_child;
+    }
+    if (right_child < heap_.size() && heap_[right_child] < heap_[smallest]) {
+      smallest = right_child;
+    }
+    if (smallest != index) {
+      T temp = heap_[index];
+      heap_[index] = heap_[smallest];
+      heap_[smallest] = temp;
+      HeapifyDown(smallest);
+    }
+  }
+
+public:
+  void push(const T &value) {
+    heap_.push_back(value);
+    HeapifyUp(heap_.size() - 1);
+  }
+
+  void pop() {
+    if (heap_.empty())
+      return;
+    heap_[0] = heap_[heap_.size() - 1];
+    heap_.pop_back();
+    if (!heap_.empty()) {
+      HeapifyDown(0);
+    }
+  }
+
+  void replace_top(const T &value) {
+    pop();
+    push(value);
+  }
+
+  T top() const { return heap_[0]; }
+
+  bool empty() const { return heap_.empty(); }
+};
+
+/**
+ * @brief Event times of one benchmark workload.
+ */
+struct Workload {
+  const char *name;            // Label of the distributions used.
+  Vector<double> start_times;  // Time of the first event of each ride.
+  Vector<double> travel_times; // Segment travel times, cycled through.
+};
+
+/**
+ * @brief Ride start times and segment travel times drawn from a distribution.
+ *
+ * Rides arrive as a Poisson process of rate 1 with integer timestamps, as in
+ * the input files. With `peaks`, the rate swings between 0.2 and 5 over a
+ * period of 1000 time units, mimicking rush hours.
+ */
+template <typename TravelDistribution>
+void BuildWorkload(long rides, bool peaks, TravelDistribution travel,
+                   Workload &workload) {
+  std::mt19937_64 rng(42);
+  std::exponential_distribution<double> gap(1.0);
+  double time = 0;
+  for (long k = 0; k < rides; ++k) {
+    double rate = peaks ? std::exp(1.6 * std::sin(time * 0.00628)) : 1.0;
+    time += gap(rng) / rate;
+    workload.start_times.push_back(std::floor(time));
+  }
+  for (int i = 0; i < 4096; ++i) {
+    workload.travel_times.push_back(travel(rng));
+  }
+}
+
+/**
+ * @brief Schedules every ride (Phase 2), then simulates them (Phase 3).
+ * @tparam kReplaceTop Whether successors replace the top in one operation.
+ * @param workload The event times.
+ * @param stops The number of segments per ride.
+ * @param[out] push_seconds Time spent scheduling the first events.
+ * @param[out] checksum Sum of the event times, to keep the work observable.
+ * @return The number of events processed.
+ */
+template <typename Queue, bool kReplaceTop>
+long RunHoldModel(const Workload &workload, int stops, double &push_seconds,
+                  double &checksum) {
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  Queue queue;
+  for (size_t k = 0; k < workload.start_times.size(); ++k) {
+    Event e;
+    e.time = workload.start_times[k];
+    e.sequence = MakeEventSequence(k, 0);
+    queue.push(e);
+  }
+  push_seconds = std::chrono::duration<double>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+  const Vector<double> &travel_times = workload.travel_times;
+  long processed = 0;
+  size_t next_time = 0;
+  checksum = 0;
+  while (!queue.empty()) {
+    Event e = queue.top();
+    ++processed;
+    checksum += e.time;
+    if (e.GetStopIndex() < stops) {
+      Event next_event = e;
+      next_event.time = e.time + travel_times[next_time];
+      next_event.sequence = e.sequence + 1;
+      next_time = (next_time + 1) % travel_times.size();
+      if (kReplaceTop) {
+        queue.replace_top(next_event);
+      } else {
+        queue.pop();
+        queue.push(next_event);
+      }
+    } else {
+      queue.pop();
+    }
+  }
+  return processed;
+}
+
+template <typename Queue, bool kReplaceTop>
+void Report(const char *name, const Workload &workload, int stops) {
+  double push_seconds = 0;
+  double checksum = 0;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  long processed =
+      RunHoldModel<Queue, kReplaceTop>(workload, stops, push_seconds, checksum);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  std::printf("%-16s %-10s %10ld %12.2f %12.2f %20.0f\n", workload.name, name,
+              processed, workload.start_times.size() / push_seconds / 1e6,
+              processed / seconds / 1e6, checksum);
+}
+
+void ReportAll(const Workload &workload, int stops) {
+  Report<CheckedMinHeap<Event>, false>("checked", workload, stops);
+  Report<MinHeap<Event, 2>, false>("heap2-pop", workload, stops);
+  Report<MinHeap<Event, 2>, true>("heap2", workload, stops);
+  Report<MinHeap<Event, 4>, true>("heap4", workload, stops);
+  Report<MinHeap<Event, 8>, true>("heap8", workload, stops);
+  Report<CalendarQueue<Event>, true>("calendar", workload, stops);
+}
+
+/**
+ * @brief Times one run of a workload and returns its events per second.
+ */
+template <typename Queue>
+double Throughput(const Workload &workload, int stops) {
+  double push_seconds = 0;
+  double checksum = 0;
+  std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  long processed =
+      RunHoldModel<Queue, true>(workload, stops, push_seconds, checksum);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  return processed / seconds;
+}
+
+/**
+ * @brief Compares the heaps with the calendar queue over growing numbers of
+ * concurrent rides, to find where the calendar queue starts to win.
+ */
+void ReportCrossover(int stops) {
+  std::printf("\ncrossover (poisson/exp, Mevents/s)\n");
+  std::printf("%10s %10s %10s %10s %10s\n", "rides", "heap2", "heap4",
+              "calendar", "cal/heap2");
+  for (long rides = 100; rides <= 3000000; rides *= 3) {
+    Workload workload = {"", Vector<double>(), Vector<double>()};
+    BuildWorkload(rides, false, std::exponential_distribution<double>(0.1),
+                  workload);
+    // Repeat small workloads so that every measurement lasts long enough.
+    int repetitions = (int)(3000000 / (rides * (stops + 1)) + 1);
+    double heap2 = 0, heap4 = 0, calendar = 0;
+    for (int r = 0; r < repetitions; ++r) {
+      heap2 += Throughput<MinHeap<Event, 2> >(workload, stops);
+      heap4 += Throughput<MinHeap<Event, 4> >(workload, stops);
+      calendar += Throughput<CalendarQueue<Event> >(workload, stops);
+    }
+    std::printf("%10ld %10.2f %10.2f %10.2f %10.2f\n", rides,
+                heap2 / repetitions / 1e6, heap4 / repetitions / 1e6,
+                calendar / repetitions / 1e6, calendar / heap2);
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  long rides = (argc > 1) ? std::atol(argv[1]) : 1000000;
+  int stops = (argc > 2) ? std::atoi(argv[2]) : 5;
+
+  std::printf("%ld rides, %d segments each\n", rides, stops);
+  std::printf("%-16s %-10s %10s %12s %12s %20s\n", "workload", "queue",
+              "events", "Mpushes/s", "Mevents/s", "checksum");
+
+  Workload exponential = {"poisson/exp", Vector<double>(), Vector<double>()};
+  BuildWorkload(rides, false, std::exponential_distribution<double>(0.1),
+                exponential);
+  ReportAll(exponential, stops);
+
+  Workload lognormal = {"poisson/lognorm", Vector<double>(), Vector<double>()};
+  BuildWorkload(rides, false, std::lognormal_distribution<double>(2.0, 1.0),
+                lognormal);
+  ReportAll(lognormal, stops);
+
+  Workload peaks = {"peaks/exp", Vector<double>(), Vector<double>()};
+  BuildWorkload(rides, true, std::exponential_distribution<double>(0.1),
+                peaks);
+  ReportAll(peaks, stops);
+
+  ReportCrossover(stops);
+  return 0;
+}
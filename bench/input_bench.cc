@@ -0,0 +1,117 @@
+/**
+ * @file input_bench.cc
+ * @brief Compares the throughput of the input parsers.
+ *
+ * Parses the same input file into a RequestTable with the original
+ * `operator>>` loop (one `std::string` per line) and with the InputReader, and
+ * reports each one in MB/s.
+ *
+ * Usage: input_bench.out <input_file> [repetitions]
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "input_reader.h"
+#include "point.h"
+#include "request_table.h"
+
+namespace {
+
+/**
+ * @brief Parses the file with iostreams, as main() originally did.
+ * @return The number of requests read.
+ */
+size_t ParseWithStreams(const char *path) {
+  std::ifstream in(path);
+  int capacity, num_requests;
+  double speed, max_wait_time, max_delay, max_distance, min_efficiency;
+  in >> capacity >> speed >> max_wait_time >> max_delay >> max_distance >>
+      min_efficiency >> num_requests;
+
+  RequestTable table;
+  for (int i = 0; i < num_requests; ++i) {
+    std::string id;
+    long time;
+    double ox, oy, dx, dy;
+    in >> id >> time >> ox >> oy >> dx >> dy;
+    table.Append(id.data(), id.size(), time, Point(ox, oy), Point(dx, dy));
+  }
+  return table.size();
+}
+
+/**
+ * @brief Parses the file with the InputReader into a RequestTable.
+ * @return The number of requests read.
+ */
+size_t ParseWithReader(const char *path) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0)
+    return 0;
+
+  InputReader reader;
+  reader.Open(fd);
+  int capacity, num_requests;
+  double speed, max_wait_time, max_delay, max_distance, min_efficiency;
+  reader.ReadInt(capacity);
+  reader.ReadDouble(speed);
+  reader.ReadDouble(max_wait_time);
+  reader.ReadDouble(max_delay);
+  reader.ReadDouble(max_distance);
+  reader.ReadDouble(min_efficiency);
+  reader.ReadInt(num_requests);
+
+  RequestTable table;
+  size_t count = reader.ReadRequests(table, num_requests);
+  close(fd);
+  return count;
+}
+
+/**
+ * @brief Runs a parser several times and prints its best throughput.
+ */
+void Report(const char *name, size_t (*parse)(const char *), const char *path,
+            double megabytes, int repetitions) {
+  double best = 0.0;
+  size_t count = 0;
+  for (int i = 0; i < repetitions; ++i) {
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+    count = parse(path);
+    std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    double throughput = megabytes / elapsed.count();
+    if (throughput > best)
+      best = throughput;
+  }
+  std::printf("%-8s %10zu requests %10.1f MB/s\n", name, count, best);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <input_file> [repetitions]\n", argv[0]);
+    return 1;
+  }
+  const char *path = argv[1];
+  int repetitions = (argc > 2) ? std::atoi(argv[2]) : 3;
+
+  std::ifstream probe(path, std::ios::binary | std::ios::ate);
+  if (!probe) {
+    std::fprintf(stderr, "cannot open %s\n", path);
+    return 1;
+  }
+  double megabytes = (double)probe.tellg() / (1024.0 * 1024.0);
+  std::printf("input    %10.1f MB\n", megabytes);
+
+  Report("iostream", ParseWithStreams, path, megabytes, repetitions);
+  Report("reader", ParseWithReader, path, megabytes, repetitions);
+  return 0;
+}
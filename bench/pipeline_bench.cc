@@ -0,0 +1,157 @@
+/**
+ * @file pipeline_bench.cc
+ * @brief End-to-end benchmark of the simulator with per-phase timings.
+ *
+ * Runs the simulator's own pipeline (RunPipeline) over an input file:
+ * reading, Phase 1 grouping, Phase 2 scheduling, Phase 3 simulation and the
+ * final flush of the output, which is written to /dev/null. Every phase is
+ * timed separately and the results are printed as one JSON object on stdout,
+ * together with the request and event throughputs and the peak resident set
+ * size of the process.
+ *
+ * Phase 3 formats the output lines as rides complete, so its time includes
+ * the formatting; the "output" phase is only the last write. With
+ * `--streaming` the phases are interleaved, and each one is reported as its
+ * time summed over the batches.
+ *
+ * The remaining arguments are the simulator's options (see ParseOptions).
+ * bench/run_pipeline.sh runs it over generated inputs of growing sizes.
+ *
+ * Usage: pipeline_bench.out <input_file> [simulator options]
+ */
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+
+#include "input_reader.h"
+#include "options.h"
+#include "output_writer.h"
+#include "pipeline.h"
+#include "simulation.h"
+#include "stats.h"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+double SecondsSince(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+const char *GroupingName(GroupingMode mode) {
+  return (mode == GroupingMode::kGrid) ? "grid" : "greedy";
+}
+
+const char *QueueName(EventQueueKind kind) {
+  switch (kind) {
+  case EventQueueKind::kQuaternaryHeap:
+    return "heap4";
+  case EventQueueKind::kOctonaryHeap:
+    return "heap8";
+  case EventQueueKind::kCalendar:
+    return "calendar";
+  case EventQueueKind::kBinaryHeap:
+  default:
+    return "heap2";
+  }
+}
+
+/**
+ * @brief Prints a string as a JSON string literal.
+ */
+void PrintJsonString(const char *text) {
+  std::putchar('"');
+  for (const char *c = text; *c != '\0'; ++c) {
+    unsigned char byte = (unsigned char)*c;
+    if (byte == '"' || byte == '\\') {
+      std::putchar('\\');
+      std::putchar(byte);
+    } else if (byte < 0x20) {
+      std::printf("\\u%04x", byte);
+    } else {
+      std::putchar(byte);
+    }
+  }
+  std::putchar('"');
+}
+
+/**
+ * @brief Gets the peak resident set size of the process.
+ * @return The peak RSS in kilobytes.
+ */
+long PeakRssKilobytes() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s <input_file> [simulator options]\n",
+                 argv[0]);
+    return 1;
+  }
+  const char *path = argv[1];
+
+  // The simulator options follow the file name.
+  SimulationOptions options;
+  argv[1] = argv[0];
+  if (!ParseOptions(argc - 1, argv + 1, options)) {
+    return 1;
+  }
+
+  int fd = open(path, O_RDONLY);
+  int null_fd = open("/dev/null", O_WRONLY);
+  if (fd < 0 || null_fd < 0) {
+    std::perror(path);
+    return 1;
+  }
+
+  Clock::time_point start = Clock::now();
+  InputReader reader;
+  reader.Open(fd);
+  OutputWriter output(null_fd);
+  RunStats stats;
+  if (!RunPipeline(options, reader, output, &stats)) {
+    std::fprintf(stderr, "%s: missing parameters\n", path);
+    return 1;
+  }
+  double total_seconds = SecondsSince(start);
+
+  // Streaming always schedules rides at their completion time.
+  bool fast = options.streaming || options.simulation == SimulationMode::kFast;
+  std::printf("{\"input\": ");
+  PrintJsonString(path);
+  std::printf(", \"grouping\": \"%s\", \"queue\": \"%s\", "
+              "\"simulation\": \"%s\", \"streaming\": %s, \"threads\": %d, "
+              "\"requests\": %zu, ",
+              GroupingName(options.grouping), QueueName(options.event_queue),
+              fast ? "fast" : "segments",
+              options.streaming ? "true" : "false", options.threads,
+              stats.requests);
+  std::printf("\"rides\": %llu, \"events\": %llu, ", stats.GetRideCount(),
+              stats.simulation.events);
+  std::printf("\"phases\": {\"read\": %.6f, \"group\": %.6f, "
+              "\"schedule\": %.6f, \"simulate\": %.6f, \"output\": %.6f}, ",
+              stats.read_seconds, stats.group_seconds,
+              stats.simulation.schedule_seconds,
+              stats.simulation.simulate_seconds, stats.output_seconds);
+  double event_seconds =
+      stats.simulation.schedule_seconds + stats.simulation.simulate_seconds;
+  std::printf("\"total_seconds\": %.6f, \"requests_per_second\": %.0f, "
+              "\"events_per_second\": %.0f, \"peak_rss_kb\": %ld}\n",
+              total_seconds, stats.requests / total_seconds,
+              event_seconds > 0 ? stats.simulation.events / event_seconds
+                                : 0.0,
+              PeakRssKilobytes());
+
+  close(null_fd);
+  close(fd);
+  return 0;
+}
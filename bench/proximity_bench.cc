@@ -0,0 +1,93 @@
+/**
+ * @file proximity_bench.cc
+ * @brief Microbenchmark for the Constraint 2 proximity kernels.
+ *
+ * For several ride sizes, checks a stream of candidates against the riders'
+ * coordinate arrays with every kernel available on this CPU, and reports the
+ * time per call and the number of rider comparisons per second. Candidates
+ * are drawn from the same cluster as the riders, so most calls scan every
+ * rider, as they do when a ride keeps growing.
+ *
+ * Usage: proximity_bench.out [calls_per_size]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "point.h"
+#include "proximity_kernel.h"
+#include "vector.h"
+
+namespace {
+
+const char *IsaName(ProximityIsa isa) {
+  switch (isa) {
+  case ProximityIsa::kScalar:
+    return "scalar";
+  case ProximityIsa::kSse2:
+    return "sse2";
+  case ProximityIsa::kAvx2:
+    return "avx2";
+  }
+  return "unknown";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  long calls = (argc > 1) ? std::atol(argv[1]) : 2000000;
+  const size_t kSizes[] = {2, 4, 6, 8, 16, 64, 256};
+  const ProximityIsa kIsas[] = {ProximityIsa::kScalar, ProximityIsa::kSse2,
+                                ProximityIsa::kAvx2};
+  const size_t kCandidates = 1024;
+  const double kMaxDistance = 2.0;
+
+  std::mt19937_64 rng(42);
+  std::normal_distribution<double> spread(0.0, 0.3);
+
+  std::printf("best isa: %s\n", IsaName(GetBestProximityIsa()));
+  std::printf("%6s %8s %12s %14s %8s\n", "riders", "isa", "ns/call",
+              "riders/s", "passed");
+
+  for (size_t s = 0; s < sizeof(kSizes) / sizeof(kSizes[0]); ++s) {
+    size_t riders = kSizes[s];
+    Vector<double> ox, oy, dx, dy;
+    for (size_t i = 0; i < riders; ++i) {
+      ox.push_back(10.0 + spread(rng));
+      oy.push_back(10.0 + spread(rng));
+      dx.push_back(50.0 + spread(rng));
+      dy.push_back(50.0 + spread(rng));
+    }
+    Vector<Point> origins, dests;
+    for (size_t i = 0; i < kCandidates; ++i) {
+      origins.push_back(Point(10.0 + spread(rng), 10.0 + spread(rng)));
+      dests.push_back(Point(50.0 + spread(rng), 50.0 + spread(rng)));
+    }
+
+    for (size_t k = 0; k < sizeof(kIsas) / sizeof(kIsas[0]); ++k) {
+      ProximityKernel kernel = GetProximityKernel(kIsas[k]);
+      if (kernel == nullptr)
+        continue;
+
+      long passed = 0;
+      std::chrono::steady_clock::time_point start =
+          std::chrono::steady_clock::now();
+      for (long c = 0; c < calls; ++c) {
+        size_t q = (size_t)c & (kCandidates - 1);
+        passed += kernel(ox.begin(), oy.begin(), dx.begin(), dy.begin(),
+                         riders, origins[q], dests[q],
+                         kMaxDistance * kMaxDistance);
+      }
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+
+      double ns_per_call = elapsed.count() * 1e9 / calls;
+      double riders_per_second = (double)riders * calls / elapsed.count();
+      std::printf("%6zu %8s %12.2f %14.3e %8ld\n", riders, IsaName(kIsas[k]),
+                  ns_per_call, riders_per_second, passed);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,27 @@
+#!/bin/sh
+# Runs pipeline_bench.out over generated inputs of 10^3 requests up to
+# max_requests, growing tenfold, and prints the results as a JSON array.
+# Each size runs in its own process, so the peak RSS is per size.
+#
+# Usage: bench/run_pipeline.sh [max_requests] [simulator options]
+# (after make bench tools; inputs go to a temporary directory)
+
+BIN=$(dirname "$0")/../bin
+MAX=${1:-10000000}
+[ $# -gt 0 ] && shift
+
+WORK=$(mktemp -d) || exit 1
+trap 'rm -rf "$WORK"' EXIT
+
+echo "["
+SEP=""
+N=1000
+while [ "$N" -le "$MAX" ]; do
+  "$BIN/workload_gen.out" --requests="$N" --peak=2 --seed=1 > "$WORK/input.txt" || exit 1
+  RESULT=$("$BIN/pipeline_bench.out" "$WORK/input.txt" "$@") || exit 1
+  printf '%s  %s' "$SEP" "$RESULT"
+  SEP=",
+"
+  N=$((N * 10))
+done
+printf '\n]\n'
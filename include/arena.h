@@ -0,0 +1,135 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_ARENA_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_ARENA_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief A bump allocator that releases all of its objects at once.
+ *
+ * The Arena carves objects out of large memory blocks by advancing a pointer,
+ * so an allocation costs a few instructions instead of a call to the global
+ * allocator. Individual objects are never freed; instead, every object is
+ * destroyed and every block is returned in a single `Release` call at the end
+ * of a simulation run or batch.
+ *
+ * Objects whose type has a non-trivial destructor are recorded in a
+ * finalizer list (itself allocated from the arena) and destroyed in reverse
+ * order of construction when the arena is released.
+ *
+ * It is used to allocate `Ride` and `Segment` objects, which are created in
+ * large numbers and all live until the end of the simulation.
+ */
+class Arena {
+private:
+  /**
+   * @brief Header of a memory block. The usable memory follows it.
+   */
+  struct Block {
+    Block *next; // Previously allocated block.
+    size_t size; // Number of usable bytes in this block.
+  };
+
+  /**
+   * @brief A pending destructor call for an object living in the arena.
+   */
+  struct Finalizer {
+    Finalizer *next;         // Previously registered finalizer.
+    void (*destroy)(void *); // Type-erased destructor.
+    void *object;            // The object to destroy.
+  };
+
+  Block *blocks_;         // Most recently allocated block.
+  char *cursor_;          // Next free byte in the current block.
+  char *limit_;           // One past the last byte of the current block.
+  size_t block_size_;     // Default usable size of new blocks.
+  size_t bytes_used_;     // Total bytes handed out since the last release.
+  Finalizer *finalizers_; // Most recently registered finalizer.
+
+  /**
+   * @brief Allocates a new block able to hold at least `min_size` bytes.
+   * @param min_size The minimum number of usable bytes.
+   */
+  void Grow(size_t min_size);
+
+  /**
+   * @brief Calls the destructor of an object of type T.
+   * @param object Pointer to the object.
+   */
+  template <typename T> static void Destroy(void *object) {
+    static_cast<T *>(object)->~T();
+  }
+
+  // Copying is not supported.
+  Arena(const Arena &);
+  Arena &operator=(const Arena &);
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * No memory is allocated until the first request.
+   *
+   * @param block_size The usable size, in bytes, of each memory block.
+   */
+  explicit Arena(size_t block_size = 64 * 1024);
+
+  /**
+   * @brief Destructor.
+   *
+   * Releases every object and block owned by the arena.
+   */
+  ~Arena();
+
+  /**
+   * @brief Allocates raw, uninitialized memory.
+   *
+   * Time Complexity: O(1) amortized.
+   *
+   * @param size The number of bytes to allocate.
+   * @param alignment The required alignment (a power of two).
+   * @return Pointer to the allocated memory.
+   */
+  void *Allocate(size_t size, size_t alignment);
+
+  /**
+   * @brief Constructs an object of type T inside the arena.
+   *
+   * The object lives until the arena is released. If T has a non-trivial
+   * destructor, it is called during `Release`.
+   *
+   * @param args Arguments forwarded to the constructor of T.
+   * @return Pointer to the new object.
+   */
+  template <typename T, typename... Args> T *New(Args &&...args) {
+    void *memory = Allocate(sizeof(T), alignof(T));
+    T *object = new (memory) T(std::forward<Args>(args)...);
+    if (!std::is_trivially_destructible<T>::value) {
+      Finalizer *finalizer = static_cast<Finalizer *>(
+          Allocate(sizeof(Finalizer), alignof(Finalizer)));
+      finalizer->next = finalizers_;
+      finalizer->destroy = &Destroy<T>;
+      finalizer->object = object;
+      finalizers_ = finalizer;
+    }
+    return object;
+  }
+
+  /**
+   * @brief Destroys every object and frees every block.
+   *
+   * Destructors run in reverse order of construction. The arena can be reused
+   * afterwards.
+   */
+  void Release();
+
+  /**
+   * @brief Gets the number of bytes handed out since the last release.
+   * @return The number of bytes in use.
+   */
+  size_t GetBytesUsed() const;
+};
+
+#endif
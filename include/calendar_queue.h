@@ -0,0 +1,368 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_CALENDAR_QUEUE_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_CALENDAR_QUEUE_H_
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include "vector.h"
+
+/**
+ * @brief A priority queue for timestamped events, after Brown's calendar
+ * queue.
+ *
+ * Time is divided into "days" of a fixed width, and the days are assigned
+ * round-robin to an array of buckets, like the days of a year on a desk
+ * calendar. Each bucket is a sorted list. Dequeuing walks the calendar from
+ * the day of the last dequeued event: the first bucket whose earliest event
+ * falls on the current day holds the minimum. When events are near-monotone,
+ * as in a discrete event simulation, a dequeue scans a bounded number of
+ * buckets and an enqueue sorts into a list of a few events, so both take O(1)
+ * amortized time instead of O(log n) for a heap.
+ *
+ * The number of buckets is kept between half and twice the number of events,
+ * and the day width is re-estimated from the separation of the earliest
+ * events whenever the calendar is resized. List nodes live in a pool and are
+ * recycled through a free list, so steady-state push and pop do not allocate;
+ * resizing only allocates when the bucket array grows past its capacity.
+ *
+ * It offers the same push/top/pop interface as MinHeap.
+ *
+ * @tparam T The type of elements stored in the queue. Must have a `double
+ * time` member and an `<` operator ordering by it (ties may be broken by
+ * other fields). Equal elements are dequeued in insertion order.
+ */
+template <typename T> class CalendarQueue {
+private:
+  static const size_t kNone = (size_t)-1; // Null node index.
+  static const size_t kMinBuckets = 16;
+  static const size_t kSampleSize = 25; // Events sampled to estimate a width.
+
+  /**
+   * @brief A list node holding one event.
+   */
+  struct Node {
+    T value;     // The event.
+    size_t next; // Next node of the bucket or free list, or kNone.
+  };
+
+  Vector<Node> nodes_;    // Node pool.
+  size_t free_;           // First node of the free list, or kNone.
+  Vector<size_t> heads_;  // First (earliest) node of each bucket, or kNone.
+  size_t bucket_mask_;    // Number of buckets minus one (a power of two).
+  double width_;          // Width of a day.
+  double inverse_width_;  // Reciprocal of width_.
+  size_t count_;          // Number of events in the queue.
+  mutable long long day_; // Day of the last dequeued event, where the search
+                          // for the next one starts.
+  mutable size_t top_;    // Bucket holding the earliest event, or kNone.
+
+  /**
+   * @brief Computes the day of a time.
+   * @param time The time.
+   * @return The index of the day containing the time.
+   */
+  long long DayOf(double time) const {
+    double day = std::floor(time * inverse_width_);
+    if (!(day > -4.0e18))
+      return (long long)-4.0e18;
+    if (day > 4.0e18)
+      return (long long)4.0e18;
+    return (long long)day;
+  }
+
+  /**
+   * @brief Accesses the event held by a node.
+   */
+  const T &ValueOf(size_t node) const {
+    return nodes_.unchecked_at(node).value;
+  }
+
+  /**
+   * @brief Finds the bucket holding the earliest event.
+   *
+   * Scans one year of days starting at day_. If no bucket holds an event of
+   * the day being scanned (the events are sparse or far in the future), the
+   * earliest event is found by comparing the head of every bucket, and the
+   * scan position jumps to its day.
+   *
+   * @return The index of the bucket. The queue must not be empty.
+   */
+  size_t Locate() const {
+    if (top_ != kNone)
+      return top_;
+
+    size_t bucket_count = bucket_mask_ + 1;
+    long long day = day_;
+    for (size_t n = 0; n < bucket_count; ++n, ++day) {
+      size_t index = (size_t)day & bucket_mask_;
+      size_t head = heads_.unchecked_at(index);
+      if (head != kNone && DayOf(ValueOf(head).time) <= day) {
+        day_ = day;
+        top_ = index;
+        return index;
+      }
+    }
+
+    // Direct search over the earliest event of every bucket.
+    size_t best = kNone;
+    for (size_t index = 0; index < bucket_count; ++index) {
+      size_t head = heads_.unchecked_at(index);
+      if (head != kNone &&
+          (best == kNone ||
+           ValueOf(head) < ValueOf(heads_.unchecked_at(best)))) {
+        best = index;
+      }
+    }
+    day_ = DayOf(ValueOf(heads_.unchecked_at(best)).time);
+    top_ = best;
+    return best;
+  }
+
+  /**
+   * @brief Links a node into its bucket, keeping the bucket sorted.
+   *
+   * The node is placed after every node that does not come after it, so equal
+   * events keep their insertion order.
+   *
+   * @param node The node to link.
+   */
+  void Link(size_t node) {
+    const T &value = ValueOf(node);
+    size_t *link =
+        &heads_.unchecked_at((size_t)DayOf(value.time) & bucket_mask_);
+    while (*link != kNone && !(value < ValueOf(*link))) {
+      link = &nodes_.unchecked_at(*link).next;
+    }
+    nodes_.unchecked_at(node).next = *link;
+    *link = node;
+  }
+
+  /**
+   * @brief Unlinks the earliest node of a bucket.
+   * @param bucket The bucket, which must not be empty.
+   * @return The unlinked node.
+   */
+  size_t UnlinkHead(size_t bucket) {
+    size_t node = heads_.unchecked_at(bucket);
+    heads_.unchecked_at(bucket) = nodes_.unchecked_at(node).next;
+    return node;
+  }
+
+  /**
+   * @brief Re-estimates the day width and redistributes every event over a
+   * new number of buckets.
+   *
+   * Following Brown, the width is three times the average separation of the
+   * earliest events, ignoring separations larger than twice the average. The
+   * width is kept if the earliest events share the same time.
+   *
+   * @param bucket_count The new number of buckets (a power of two).
+   */
+  void Resize(size_t bucket_count) {
+    // Unlink the earliest events, in order, to sample their separation.
+    size_t sample[kSampleSize];
+    size_t sampled = 0;
+    while (sampled < kSampleSize && sampled < count_) {
+      sample[sampled++] = UnlinkHead(Locate());
+      top_ = kNone;
+    }
+    if (sampled >= 2) {
+      size_t gaps = sampled - 1;
+      double average =
+          (ValueOf(sample[gaps]).time - ValueOf(sample[0]).time) / gaps;
+      double sum = 0;
+      size_t kept = 0;
+      for (size_t i = 0; i < gaps; ++i) {
+        double gap = ValueOf(sample[i + 1]).time - ValueOf(sample[i]).time;
+        if (gap <= 2.0 * average) {
+          sum += gap;
+          ++kept;
+        }
+      }
+      if (kept > 0 && sum > 0) {
+        width_ = 3.0 * sum / kept;
+        inverse_width_ = 1.0 / width_;
+      }
+    }
+
+    // Gather the remaining nodes into one chain, keeping the order of each
+    // bucket so that equal events stay in insertion order, then relink
+    // everything.
+    size_t chain = kNone;
+    size_t *tail = &chain;
+    for (size_t i = 0; i < heads_.size(); ++i) {
+      if (heads_.unchecked_at(i) == kNone)
+        continue;
+      *tail = heads_.unchecked_at(i);
+      while (*tail != kNone) {
+        tail = &nodes_.unchecked_at(*tail).next;
+      }
+    }
+    heads_.clear();
+    for (size_t i = 0; i < bucket_count; ++i) {
+      heads_.push_back(kNone);
+    }
+    bucket_mask_ = bucket_count - 1;
+
+    for (size_t i = 0; i < sampled; ++i) {
+      Link(sample[i]);
+    }
+    while (chain != kNone) {
+      size_t node = chain;
+      chain = nodes_.unchecked_at(node).next;
+      Link(node);
+    }
+    top_ = kNone;
+    if (sampled > 0) {
+      day_ = DayOf(ValueOf(sample[0]).time);
+    }
+  }
+
+public:
+  /**
+   * @brief Default constructor.
+   *
+   * Initializes an empty queue with the minimum number of buckets and a day
+   * width of 1.
+   */
+  CalendarQueue()
+      : free_(kNone), bucket_mask_(kMinBuckets - 1), width_(1.0),
+        inverse_width_(1.0), count_(0), day_(0), top_(kNone) {
+    for (size_t i = 0; i < kMinBuckets; ++i) {
+      heads_.push_back(kNone);
+    }
+  }
+
+  /**
+   * @brief Inserts a new element into the queue.
+   *
+   * Time Complexity: O(1) amortized for near-monotone times.
+   *
+   * @param value The value to be inserted.
+   */
+  void push(const T &value) {
+    size_t node = free_;
+    if (node != kNone) {
+      free_ = nodes_.unchecked_at(node).next;
+      nodes_.unchecked_at(node).value = value;
+    } else {
+      node = nodes_.size();
+      Node fresh;
+      fresh.value = value;
+      fresh.next = kNone;
+      nodes_.push_back(fresh);
+    }
+
+    long long day = DayOf(ValueOf(node).time);
+    if (count_ == 0 || day < day_) {
+      day_ = day;
+    }
+    Link(node);
+    ++count_;
+    top_ = kNone;
+
+    if (count_ > 2 * (bucket_mask_ + 1)) {
+      Resize(2 * (bucket_mask_ + 1));
+    }
+  }
+
+  /**
+   * @brief Removes the earliest element from the queue.
+   *
+   * If the queue is empty, this operation does nothing.
+   *
+   * Time Complexity: O(1) amortized for near-monotone times.
+   */
+  void pop() {
+    if (empty())
+      return;
+    size_t node = UnlinkHead(Locate());
+    nodes_.unchecked_at(node).next = free_;
+    free_ = node;
+    --count_;
+    top_ = kNone;
+
+    if (bucket_mask_ + 1 > kMinBuckets && count_ < (bucket_mask_ + 1) / 2) {
+      Resize((bucket_mask_ + 1) / 2);
+    }
+  }
+
+  /**
+   * @brief Removes the earliest element and returns it.
+   *
+   * @return The former top element.
+   * @throws std::out_of_range If the queue is empty.
+   */
+  T pop_top() {
+    T result = top();
+    pop();
+    return result;
+  }
+
+  /**
+   * @brief Replaces the earliest element with a new value.
+   *
+   * Equivalent to pop() followed by push(value), reusing the same node.
+   *
+   * @param value The value that replaces the top.
+   * @throws std::out_of_range If the queue is empty.
+   */
+  void replace_top(const T &value) {
+    if (empty())
+      throw std::out_of_range("Queue is empty");
+    size_t node = UnlinkHead(Locate());
+    nodes_.unchecked_at(node).value = value;
+    long long day = DayOf(value.time);
+    if (day < day_) {
+      day_ = day;
+    }
+    Link(node);
+    top_ = kNone;
+  }
+
+  /**
+   * @brief Accesses the earliest element of the queue.
+   *
+   * Time Complexity: O(1) amortized for near-monotone times.
+   *
+   * @return A constant reference to the earliest element, valid until the
+   * queue is next modified.
+   * @throws std::out_of_range If the queue is empty.
+   */
+  const T &top() const {
+    if (empty())
+      throw std::out_of_range("Queue is empty");
+    return ValueOf(heads_.unchecked_at(Locate()));
+  }
+
+  /**
+   * @brief Checks if the queue is empty.
+   *
+   * @return true if the queue contains no elements, false otherwise.
+   */
+  bool empty() const { return count_ == 0; }
+
+  /**
+   * @brief Returns the number of elements in the queue.
+   *
+   * @return The number of elements in the queue.
+   */
+  size_t size() const { return count_; }
+
+  /**
+   * @brief Preallocates nodes for a number of elements.
+   *
+   * The buckets are sized from the queue's contents, since the day width can
+   * only be estimated from actual events.
+   *
+   * @param count The number of elements to make room for.
+   */
+  void reserve(size_t count) { nodes_.reserve(count); }
+};
+
+template <typename T> const size_t CalendarQueue<T>::kNone;
+template <typename T> const size_t CalendarQueue<T>::kMinBuckets;
+template <typename T> const size_t CalendarQueue<T>::kSampleSize;
+
+#endif
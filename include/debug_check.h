@@ -0,0 +1,36 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_DEBUG_CHECK_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_DEBUG_CHECK_H_
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @file debug_check.h
+ * @brief Assertions that exist only in checked builds.
+ *
+ * Hot paths use unchecked element access (see Vector::unchecked_at). When the
+ * program is compiled with `-DRIDE_DISPATCH_DEBUG_CHECKS` (as `make sanitize`
+ * does), DEBUG_CHECK verifies the condition and aborts with its location on
+ * failure; otherwise it expands to nothing and the condition is not evaluated.
+ */
+
+/**
+ * @brief Reports a failed DEBUG_CHECK and aborts.
+ * @param condition The text of the failed condition.
+ * @param file The source file of the check.
+ * @param line The source line of the check.
+ */
+inline void DebugCheckFailed(const char *condition, const char *file,
+                             int line) {
+  std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+  std::abort();
+}
+
+#ifdef RIDE_DISPATCH_DEBUG_CHECKS
+#define DEBUG_CHECK(condition)                                                 \
+  ((condition) ? (void)0 : DebugCheckFailed(#condition, __FILE__, __LINE__))
+#else
+#define DEBUG_CHECK(condition) ((void)0)
+#endif
+
+#endif
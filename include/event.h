@@ -0,0 +1,71 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_EVENT_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_EVENT_H_
+
+#include <cstddef>
+
+/**
+ * @brief Largest number of rides an Event can refer to.
+ */
+const size_t kMaxEventRides = 0xFFFFFFFFu;
+
+/**
+ * @brief Packs a ride index and a stop index into an event sequence key.
+ *
+ * The ride index fills the high 32 bits and the stop index the low 32 bits,
+ * so comparing keys orders events by ride and then by stop.
+ *
+ * @param ride_index Index of the ride in the simulated ride list (at most
+ * kMaxEventRides).
+ * @param stop_index Index of the next stop of the ride.
+ * @return The sequence key.
+ */
+inline unsigned long long MakeEventSequence(size_t ride_index,
+                                            int stop_index) {
+  return ((unsigned long long)ride_index << 32) | (unsigned int)stop_index;
+}
+
+/**
+ * @brief Represents a discrete event in the simulation.
+ *
+ * Used to schedule and process vehicle movements.
+ *
+ * An event is a packed 16-byte record: its time and a sequence key holding
+ * the index of its ride in the simulated ride list and the index of the ride's
+ * next stop. Events are ordered by time and then by sequence key, so the order
+ * is total and every scheduler pops events with equal times in the same
+ * order: by ride, in the order the rides were formed.
+ */
+struct Event {
+  double time;                 /**< The time at which the event occurs. */
+  unsigned long long sequence; /**< Ride and stop, see MakeEventSequence. */
+
+  /**
+   * @brief Gets the index of the associated ride in the ride list.
+   * @return The ride index.
+   */
+  size_t GetRideIndex() const { return (size_t)(sequence >> 32); }
+
+  /**
+   * @brief Gets the index of the next stop to process (0 to segments.size()).
+   * @return The stop index.
+   */
+  int GetStopIndex() const { return (int)(unsigned int)sequence; }
+
+  /**
+   * @brief Comparator for MinHeap.
+   *
+   * Ties on time are broken by a single integer comparison of the sequence
+   * keys.
+   *
+   * @param other The other event to compare against.
+   * @return True if this event occurs before the other event.
+   */
+  bool operator<(const Event &other) const {
+    return time < other.time ||
+           (time == other.time && sequence < other.sequence);
+  }
+};
+
+static_assert(sizeof(Event) == 16, "Event should stay a 16-byte record");
+
+#endif
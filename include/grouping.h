@@ -0,0 +1,154 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_GROUPING_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_GROUPING_H_
+
+#include "simulation_params.h"
+#include "vector.h"
+
+class Arena;
+class Request;
+class RequestTable;
+class Ride;
+
+/**
+ * @brief Strategies for combining requests into rides (Phase 1).
+ */
+enum class GroupingMode {
+  kGreedy, /**< Only tries the following requests, stops at the first miss. */
+  kGrid    /**< Looks up nearby requests in the time window via a grid. */
+};
+
+/**
+ * @brief Counts of requests kept out of a ride, by failed constraint.
+ *
+ * With the greedy heuristic, each count is the number of rides closed by a
+ * request failing that constraint; with the grid, it is the number of
+ * candidates skipped for it (or, for capacity, of rides that filled up with
+ * candidates left).
+ */
+struct GroupingStats {
+  unsigned long long capacity_rejections;   /**< Constraint 1. */
+  unsigned long long distance_rejections;   /**< Constraint 2. */
+  unsigned long long efficiency_rejections; /**< Constraint 3. */
+  unsigned long long delay_rejections;      /**< Constraint 4. */
+
+  /**
+   * @brief Default constructor.
+   *
+   * Zeroes every count.
+   */
+  GroupingStats()
+      : capacity_rejections(0), distance_rejections(0),
+        efficiency_rejections(0), delay_rejections(0) {}
+
+  /**
+   * @brief Adds the counts of another run.
+   * @param other The counts to add.
+   */
+  void Add(const GroupingStats &other);
+};
+
+/**
+ * @brief Groups requests into rides with the original greedy heuristic.
+ *
+ * Starting from the first unassigned request, subsequent requests are added
+ * to the ride while they satisfy the four constraints (capacity, distance,
+ * efficiency and max delay); the first request that fails any of them starts
+ * the next ride. Each ride therefore holds a run of consecutive rows.
+ *
+ * @param table The requests, in input order.
+ * @param requests One view per table row.
+ * @param params The simulation parameters.
+ * @param arena The arena that allocates the rides.
+ * @param[out] rides Receives the formed rides, in order of their first
+ * request.
+ * @param[out] deferred If not null, the table is taken to be followed by more
+ * requests: the last ride, which accepted every request up to the end of the
+ * table, is not formed and its rows are appended here instead.
+ * @param[in,out] stats If not null, the rejections are counted into it.
+ */
+void GroupGreedy(const RequestTable &table, Vector<Request> &requests,
+                 const SimulationParams &params, Arena &arena,
+                 Vector<Ride *> &rides, Vector<size_t> *deferred = nullptr,
+                 GroupingStats *stats = nullptr);
+
+/**
+ * @brief Groups requests into rides using a spatial grid over origins.
+ *
+ * Each ride is seeded with the earliest unassigned request. Every request
+ * within `max_delay` of the seed is kept in a uniform grid of `max_distance`
+ * cells, so all candidates close enough to the seed are found in its 3x3 cell
+ * neighborhood in O(1) expected time. Candidates are tried in input order and
+ * one that fails a constraint is skipped rather than closing the ride, which
+ * forms far fewer single-passenger rides than the greedy heuristic.
+ *
+ * Requests are expected in non-decreasing time order, as in the input format.
+ *
+ * @param table The requests, in input order.
+ * @param requests One view per table row.
+ * @param params The simulation parameters.
+ * @param arena The arena that allocates the rides.
+ * @param[out] rides Receives the formed rides, in order of their seed.
+ * @param[out] deferred If not null, the table is taken to be followed by more
+ * requests: grouping stops at the first seed whose `max_delay` window reaches
+ * the end of the table, and that seed and every unassigned request after it
+ * are appended here, in input order.
+ * @param[in,out] stats If not null, the rejections are counted into it.
+ */
+void GroupWithGrid(const RequestTable &table, Vector<Request> &requests,
+                   const SimulationParams &params, Arena &arena,
+                   Vector<Ride *> &rides, Vector<size_t> *deferred = nullptr,
+                   GroupingStats *stats = nullptr);
+
+/**
+ * @brief Groups requests into rides with the selected strategy.
+ *
+ * With `deferred`, the table can be one batch of a longer request stream:
+ * the rides that could still take requests beyond the batch are left
+ * unformed. Grouping a new table made of the deferred rows followed by the
+ * next requests then forms exactly the rides a single pass would have.
+ *
+ * @param mode The grouping strategy.
+ * @param table The requests, in input order.
+ * @param requests One view per table row.
+ * @param params The simulation parameters.
+ * @param arena The arena that allocates the rides.
+ * @param[out] rides Receives the formed rides.
+ * @param[out] deferred If not null, receives the rows left to the next batch,
+ * in input order.
+ * @param[in,out] stats If not null, the rejections are counted into it.
+ */
+void GroupRequests(GroupingMode mode, const RequestTable &table,
+                   Vector<Request> &requests, const SimulationParams &params,
+                   Arena &arena, Vector<Ride *> &rides,
+                   Vector<size_t> *deferred = nullptr,
+                   GroupingStats *stats = nullptr);
+
+/**
+ * @brief Groups requests into rides on several threads.
+ *
+ * The requests are cut into shards at rows that come more than `max_delay`
+ * after every earlier request: no ride can include requests on both sides of
+ * such a row, with either strategy. The shards are grouped concurrently, each
+ * into its own arena (allocated from `arena`), and their rides are
+ * concatenated in order, which yields exactly the rides of GroupRequests.
+ *
+ * Falls back to GroupRequests with a single thread, or when the requests
+ * have no such gap.
+ *
+ * @param mode The grouping strategy.
+ * @param table The requests, in input order.
+ * @param requests One view per table row.
+ * @param params The simulation parameters.
+ * @param thread_count The number of worker threads.
+ * @param arena The arena that owns the rides.
+ * @param[out] rides Receives the formed rides.
+ * @param[in,out] stats If not null, the rejections are counted into it, with
+ * the same totals as a single-threaded run.
+ */
+void GroupRequestsParallel(GroupingMode mode, const RequestTable &table,
+                           Vector<Request> &requests,
+                           const SimulationParams &params, int thread_count,
+                           Arena &arena, Vector<Ride *> &rides,
+                           GroupingStats *stats = nullptr);
+
+#endif
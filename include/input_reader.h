@@ -0,0 +1,128 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_INPUT_READER_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_INPUT_READER_H_
+
+#include <cstddef>
+
+class RequestTable;
+
+/**
+ * @brief Fast tokenizer for the simulator's whitespace-separated input.
+ *
+ * When the input is a regular file, it is memory-mapped and parsed in place.
+ * Otherwise (e.g. a pipe), it is read in large blocks into an internal buffer
+ * that is refilled as tokens are consumed, so memory stays bounded.
+ *
+ * Numbers are parsed by hand, without creating strings or going through
+ * iostreams. Decimal values with up to 19 significant digits and a small
+ * exponent are converted exactly with a single floating-point operation; any
+ * other value falls back to `strtod`, so the result always matches
+ * `std::cin >> double`.
+ */
+class InputReader {
+private:
+  int fd_;           // File descriptor being read.
+  char *data_;       // Start of the mapped file or of the read buffer.
+  size_t capacity_;  // Size of the read buffer (0 when mapped).
+  size_t mapped_;    // Size of the mapping (0 when buffered).
+  const char *cur_;  // Next unread character.
+  const char *end_;  // One past the last valid character.
+  const char *mark_; // Already-read position that Refill must keep, or null.
+  bool eof_;         // Whether the whole input is in memory.
+  size_t consumed_;  // Bytes discarded from the front of the buffer so far.
+
+  /**
+   * @brief Reads more input into the buffer, keeping unread characters (and
+   * everything from `mark_` onwards, if set).
+   * @return true if any new characters were read.
+   */
+  bool Refill();
+
+  /**
+   * @brief Locates the next whitespace-delimited token.
+   *
+   * Makes sure the whole token is in memory, refilling the buffer if needed.
+   *
+   * @param[out] start Pointer to the first character of the token.
+   * @param[out] length Number of characters in the token.
+   * @return true if a token was found, false at end of input.
+   */
+  bool NextToken(const char *&start, size_t &length);
+
+  // Copying is not supported.
+  InputReader(const InputReader &);
+  InputReader &operator=(const InputReader &);
+
+public:
+  /**
+   * @brief Default constructor.
+   *
+   * The reader has no input until `Open` is called.
+   */
+  InputReader();
+
+  /**
+   * @brief Destructor.
+   *
+   * Unmaps the file or frees the read buffer. The file descriptor is not
+   * closed.
+   */
+  ~InputReader();
+
+  /**
+   * @brief Attaches the reader to an open file descriptor.
+   *
+   * Regular files are memory-mapped; anything else is read in blocks.
+   *
+   * @param fd The file descriptor to read from (e.g. 0 for stdin).
+   * @return true on success.
+   */
+  bool Open(int fd);
+
+  /**
+   * @brief Reads an integer token.
+   * @param[out] value The parsed value.
+   * @return true on success, false at end of input, on a malformed token or
+   *         on a value outside the range of int.
+   */
+  bool ReadInt(int &value);
+
+  /**
+   * @brief Reads a long integer token.
+   * @param[out] value The parsed value.
+   * @return true on success, false at end of input or on a malformed token.
+   */
+  bool ReadLong(long &value);
+
+  /**
+   * @brief Reads a floating-point token.
+   * @param[out] value The parsed value.
+   * @return true on success, false at end of input or on a malformed token.
+   */
+  bool ReadDouble(double &value);
+
+  /**
+   * @brief Reads one request line and appends it to a table.
+   *
+   * Expects `<id> <time> <origin_x> <origin_y> <dest_x> <dest_y>`.
+   *
+   * @param table The table to append to.
+   * @return true on success, false at end of input or on a malformed line.
+   */
+  bool ReadRequest(RequestTable &table);
+
+  /**
+   * @brief Reads up to `count` request lines into a table.
+   * @param table The table to append to.
+   * @param count The number of requests to read.
+   * @return The number of requests actually read.
+   */
+  size_t ReadRequests(RequestTable &table, size_t count);
+
+  /**
+   * @brief Gets the number of input bytes consumed so far.
+   * @return The byte offset of the next unread character.
+   */
+  size_t GetBytesConsumed() const;
+};
+
+#endif
@@ -1,12 +1,14 @@
 #ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_MIN_HEAP_H_
 #define RIDE_DISPATCH_SIMULATOR_INCLUDE_MIN_HEAP_H_
 
+#include <cstddef>
 #include <stdexcept>
+#include <utility>
 
 #include "vector.h"
 
 /**
- * @brief A priority queue implementation using a binary min-heap.
+ * @brief A priority queue implementation using a d-ary min-heap.
  *
  * This class provides a priority queue data structure where the element with
  * the smallest value is always at the top. It is implemented using a dynamic
@@ -17,77 +19,116 @@
  * the event scheduler (Escalonador), where events need to be processed in
  * chronological order.
  *
+ * Each node has `kArity` children. A wider heap is shallower, so sifting down
+ * touches fewer levels at the price of more comparisons per level; since the
+ * children of a node are adjacent, those comparisons mostly hit a single cache
+ * line. The storage is aligned to 64 bytes and the nodes are shifted so that
+ * every group of siblings starts at a multiple of `kArity` slots, which keeps
+ * a group within as few cache lines as its size allows.
+ *
  * @tparam T The type of elements stored in the heap. Must support the `<`
- * operator for comparison.
+ * operator for comparison and be default-constructible.
+ * @tparam kArity The number of children per node (2, 4 or 8 are typical).
  */
-template <typename T> class MinHeap {
+template <typename T, size_t kArity = 2> class MinHeap {
 private:
+  static_assert(kArity >= 2, "a heap node needs at least two children");
+
+  // Unused slots before the root, so that sibling groups start at multiples
+  // of kArity.
+  static const size_t kPadding = kArity - 1;
+
   /**
    * @brief The underlying container for storing heap elements.
    *
-   * We use a Vector to maintain the complete binary tree structure of the heap.
+   * We use a Vector to maintain the complete d-ary tree structure of the heap.
    * For a node at index `i`:
-   * - The left child is at index `2*i + 1`.
-   * - The right child is at index `2*i + 2`.
-   * - The parent is at index `(i - 1) / 2`.
+   * - The children are at indices `kArity*i + 1` to `kArity*i + kArity`.
+   * - The parent is at index `(i - 1) / kArity`.
+   *
+   * Node `i` is stored in slot `i + kPadding`; the first slots hold
+   * default-constructed padding.
+   *
+   * Every index computed below is in range by construction, so the sift
+   * operations use unchecked access.
+   */
+  Vector<T, 64> heap_;
+
+  /**
+   * @brief Accesses a node by its index in the tree.
+   * @param index The node index (must be < size()).
+   * @return Reference to the node.
+   */
+  T &Node(size_t index) { return heap_.unchecked_at(index + kPadding); }
+
+  /**
+   * @brief Accesses a node by its index in the tree (const version).
+   * @param index The node index (must be < size()).
+   * @return Const reference to the node.
    */
-  Vector<T> heap_;
+  const T &Node(size_t index) const {
+    return heap_.unchecked_at(index + kPadding);
+  }
 
   /**
-   * @brief Restores the min-heap property by moving an element up the tree.
+   * @brief Moves an element up the tree from a hole to its position.
    *
-   * This operation, compares the element at the given index
-   * with its parent. If the element is smaller than its parent,
-   * they are swapped. This process is repeated until the element is
-   * in the correct position or reaches the root.
+   * Starting at the hole, each parent larger than `value` is moved down into
+   * the hole, which climbs one level per step. The value is then moved into
+   * the final hole, so every level costs one comparison and one move instead
+   * of a three-copy swap.
    *
    * Time Complexity: O(log n), where n is the number of elements in the heap.
    *
-   * @param index The index of the element to move up.
+   * @param hole The index of the vacant slot to start from.
+   * @param value The element to place; it is moved from.
    */
-  void HeapifyUp(size_t index) {
-    if (index == 0)
-      return;
-    size_t parent_index = (index - 1) / 2;
-    if (heap_[index] < heap_[parent_index]) {
-      T temp = heap_[index];
-      heap_[index] = heap_[parent_index];
-      heap_[parent_index] = temp;
-      HeapifyUp(parent_index);
+  void HeapifyUp(size_t hole, T &value) {
+    while (hole > 0) {
+      size_t parent_index = (hole - 1) / kArity;
+      if (!(value < Node(parent_index)))
+        break;
+      Node(hole) = std::move(Node(parent_index));
+      hole = parent_index;
     }
+    Node(hole) = std::move(value);
   }
 
   /**
-   * @brief Restores the min-heap property by moving an element down the tree.
+   * @brief Moves an element down the tree from a hole to its position.
    *
-   * This operation, compares the element at the given index with its children.
-   * If the element is larger than either of its children, it is swapped with
-   * the smallest child. This process is repeated until the element is in the
-   * correct position or becomes a leaf.
+   * Starting at the hole, the smallest child is moved up into the hole while
+   * it is smaller than `value`, and the hole descends one level per step. The
+   * value is then moved into the final hole.
    *
-   * Time Complexity: O(log n), where n is the number of elements in the heap.
+   * Time Complexity: O(d log n / log d), where n is the number of elements in
+   * the heap and d its arity.
    *
-   * @param index The index of the element to move down.
+   * @param hole The index of the vacant slot to start from.
+   * @param value The element to place; it is moved from.
    */
-  void HeapifyDown(size_t index) {
-    size_t left_child = 2 * index + 1;
-    size_t right_child = 2 * index + 2;
-    size_t smallest = index;
-
-    if (left_child < heap_.size() && heap_[left_child] < heap_[smallest]) {
-      smallest = left_child;
-    }
-
-    if (right_child < heap_.size() && heap_[right_child] < heap_[smallest]) {
-      smallest = right_child;
-    }
+  void HeapifyDown(size_t hole, T &value) {
+    size_t count = size();
+    for (;;) {
+      size_t first_child = kArity * hole + 1;
+      if (first_child >= count)
+        break;
+      size_t last_child = first_child + kArity;
+      if (last_child > count)
+        last_child = count;
 
-    if (smallest != index) {
-      T temp = heap_[index];
-      heap_[index] = heap_[smallest];
-      heap_[smallest] = temp;
-      HeapifyDown(smallest);
+      size_t smallest = first_child;
+      for (size_t child = first_child + 1; child < last_child; ++child) {
+        if (Node(child) < Node(smallest)) {
+          smallest = child;
+        }
+      }
+      if (!(Node(smallest) < value))
+        break;
+      Node(hole) = std::move(Node(smallest));
+      hole = smallest;
     }
+    Node(hole) = std::move(value);
   }
 
 public:
@@ -96,7 +137,11 @@ public:
    *
    * Initializes an empty MinHeap.
    */
-  MinHeap() {}
+  MinHeap() {
+    for (size_t i = 0; i < kPadding; ++i) {
+      heap_.emplace_back();
+    }
+  }
 
   /**
    * @brief Inserts a new element into the priority queue.
@@ -110,7 +155,9 @@ public:
    */
   void push(const T &value) {
     heap_.push_back(value);
-    HeapifyUp(heap_.size() - 1);
+    size_t hole = size() - 1;
+    T item = std::move(Node(hole));
+    HeapifyUp(hole, item);
   }
 
   /**
@@ -124,13 +171,52 @@ public:
    * Time Complexity: O(log n).
    */
   void pop() {
-    if (heap_.empty())
+    if (empty())
+      return;
+    size_t last = size() - 1;
+    if (last == 0) {
+      heap_.pop_back();
       return;
-    heap_[0] = heap_[heap_.size() - 1];
-    heap_.pop_back();
-    if (!heap_.empty()) {
-      HeapifyDown(0);
     }
+    T item = std::move(Node(last));
+    heap_.pop_back();
+    HeapifyDown(0, item);
+  }
+
+  /**
+   * @brief Removes the element with the smallest value and returns it.
+   *
+   * Time Complexity: O(log n).
+   *
+   * @return The former top element.
+   * @throws std::out_of_range If the heap is empty.
+   */
+  T pop_top() {
+    if (empty())
+      throw std::out_of_range("Heap is empty");
+    T result = std::move(Node(0));
+    pop();
+    return result;
+  }
+
+  /**
+   * @brief Replaces the top element with a new value.
+   *
+   * Equivalent to pop() followed by push(value), but the new value is sifted
+   * down from the root in a single pass. This is the common case of the
+   * simulation loop, which handles the earliest event and schedules its
+   * successor.
+   *
+   * Time Complexity: O(log n).
+   *
+   * @param value The value that replaces the top.
+   * @throws std::out_of_range If the heap is empty.
+   */
+  void replace_top(const T &value) {
+    if (empty())
+      throw std::out_of_range("Heap is empty");
+    T item(value);
+    HeapifyDown(0, item);
   }
 
   /**
@@ -139,13 +225,14 @@ public:
    *
    * Time Complexity: O(1).
    *
-   * @return A constant reference to the smallest element.
+   * @return A constant reference to the smallest element, valid until the
+   * heap is next modified.
    * @throws std::out_of_range If the heap is empty.
    */
-  T top() const {
-    if (heap_.empty())
+  const T &top() const {
+    if (empty())
       throw std::out_of_range("Heap is empty");
-    return heap_[0];
+    return Node(0);
   }
 
   /**
@@ -155,7 +242,7 @@ public:
    *
    * @return true if the heap contains no elements, false otherwise.
    */
-  bool empty() const { return heap_.empty(); }
+  bool empty() const { return heap_.size() == kPadding; }
 
   /**
    * @brief Returns the number of elements in the priority queue.
@@ -164,7 +251,13 @@ public:
    *
    * @return The number of elements in the heap.
    */
-  size_t size() const { return heap_.size(); }
+  size_t size() const { return heap_.size() - kPadding; }
+
+  /**
+   * @brief Preallocates room for a number of elements.
+   * @param count The number of elements to make room for.
+   */
+  void reserve(size_t count) { heap_.reserve(count + kPadding); }
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,55 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_OPTIONS_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_OPTIONS_H_
+
+#include "grouping.h"
+#include "simulation.h"
+
+/**
+ * @brief Command-line options selecting how the simulator runs.
+ *
+ * Unlike SimulationParams, which come from the input and define the problem,
+ * these only choose between implementations. Every option defaults to the
+ * original behavior.
+ */
+struct SimulationOptions {
+  GroupingMode grouping;      /**< Strategy used to form rides. */
+  EventQueueKind event_queue; /**< Priority queue of the event scheduler. */
+  SimulationMode simulation;  /**< How the event scheduler advances rides. */
+  bool streaming;             /**< Whether to process the input in batches. */
+  int threads;                /**< Worker threads used for grouping. */
+  bool stats;                 /**< Whether to report statistics on stderr. */
+
+  /**
+   * @brief Default constructor.
+   *
+   * Selects the original greedy grouping, binary heap and per-segment
+   * simulation over the whole input, on a single thread, without
+   * statistics.
+   */
+  SimulationOptions()
+      : grouping(GroupingMode::kGreedy),
+        event_queue(EventQueueKind::kBinaryHeap),
+        simulation(SimulationMode::kPerSegment), streaming(false),
+        threads(1), stats(false) {}
+};
+
+/**
+ * @brief Parses the command-line arguments into options.
+ *
+ * Recognized arguments:
+ * - `--grouping=greedy|grid`
+ * - `--queue=heap2|heap4|heap8|calendar`
+ * - `--simulation=segments|fast`
+ * - `--streaming`
+ * - `--threads=N` (N >= 1)
+ * - `--stats`
+ *
+ * @param argc Number of arguments, as passed to main.
+ * @param argv The arguments, as passed to main.
+ * @param[out] options The parsed options.
+ * @return true on success, false if an argument is not recognized (a message
+ * is printed to stderr).
+ */
+bool ParseOptions(int argc, char **argv, SimulationOptions &options);
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_OUTPUT_WRITER_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_OUTPUT_WRITER_H_
+
+#include <cstddef>
+
+/**
+ * @brief Buffered, allocation-free text writer for the simulation results.
+ *
+ * Values are formatted directly into one large buffer that is reused for the
+ * whole run and written to the file descriptor only when it fills up (or on
+ * `Flush`), instead of going through iostreams and flushing every line.
+ *
+ * Fixed-precision doubles are produced byte-for-byte identical to
+ * `std::fixed << std::setprecision(n)` (i.e. `printf("%.nf")`): values are
+ * scaled and rounded with integer arithmetic, and the rare value that lies
+ * too close to a rounding tie to decide safely is formatted with snprintf.
+ */
+class OutputWriter {
+private:
+  int fd_;          // File descriptor the buffer is written to.
+  char *buffer_;    // Output buffer.
+  size_t capacity_; // Size of the buffer.
+  size_t used_;     // Number of pending bytes in the buffer.
+
+  /**
+   * @brief Makes sure at least `size` bytes are free in the buffer.
+   * @param size The number of bytes about to be written (<= capacity).
+   */
+  void Reserve(size_t size);
+
+  // Copying is not supported.
+  OutputWriter(const OutputWriter &);
+  OutputWriter &operator=(const OutputWriter &);
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param fd The file descriptor to write to (e.g. 1 for stdout).
+   * @param capacity The size of the output buffer in bytes; raised to the
+   *                 longest formatted number if smaller.
+   */
+  explicit OutputWriter(int fd, size_t capacity = 1 << 20);
+
+  /**
+   * @brief Destructor.
+   *
+   * Flushes any pending output and frees the buffer.
+   */
+  ~OutputWriter();
+
+  /**
+   * @brief Writes a single character.
+   * @param c The character to write.
+   */
+  void WriteChar(char c);
+
+  /**
+   * @brief Writes a sequence of characters.
+   * @param data Pointer to the characters.
+   * @param length Number of characters to write.
+   */
+  void WriteString(const char *data, size_t length);
+
+  /**
+   * @brief Writes a signed integer in decimal.
+   * @param value The value to write.
+   */
+  void WriteInt(long value);
+
+  /**
+   * @brief Writes a double in fixed notation.
+   *
+   * Equivalent to `printf("%.*f", precision, value)`.
+   *
+   * @param value The value to write.
+   * @param precision Number of digits after the decimal point. Values outside
+   *                  0 to 9 are formatted by snprintf.
+   */
+  void WriteFixed(double value, int precision);
+
+  /**
+   * @brief Writes all pending output to the file descriptor.
+   */
+  void Flush();
+};
+
+#endif
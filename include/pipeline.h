@@ -0,0 +1,33 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_PIPELINE_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_PIPELINE_H_
+
+#include "options.h"
+
+class InputReader;
+class OutputWriter;
+struct RunStats;
+
+/**
+ * @brief Runs the whole simulator over an input.
+ *
+ * Reads the simulation parameters and the requests, groups the requests into
+ * rides (Phase 1), schedules and simulates the rides (Phases 2 and 3) and
+ * flushes the output. With `--streaming`, the phases run batch by batch
+ * instead (see SimulateStream).
+ *
+ * This is the program behind main(), shared with the benchmarks so that they
+ * measure exactly what the simulator runs.
+ *
+ * @param options The options of the run (see ParseOptions).
+ * @param reader The input, positioned at its first parameter.
+ * @param output Receives one line per completed ride.
+ * @param[out] stats If not null, receives the statistics of the run. With
+ * `--streaming`, the time of each phase is summed over the batches.
+ * @return false if the input ends before the simulation parameters, in which
+ * case nothing is written.
+ * @throws std::length_error If there are more than kMaxEventRides rides.
+ */
+bool RunPipeline(const SimulationOptions &options, InputReader &reader,
+                 OutputWriter &output, RunStats *stats = nullptr);
+
+#endif
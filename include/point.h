@@ -0,0 +1,46 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_POINT_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_POINT_H_
+
+#include <cmath>
+
+/**
+ * @brief Represents a location in the two-dimensional simulation plane.
+ *
+ * Coordinates are kept in binary form from the moment they are read until
+ * they are written to the output, so distance computations never have to
+ * parse text.
+ */
+struct Point {
+  double x; /**< X-coordinate. */
+  double y; /**< Y-coordinate. */
+
+  /**
+   * @brief Default constructor.
+   *
+   * Initializes the point at the origin (0, 0).
+   */
+  Point() : x(0.0), y(0.0) {}
+
+  /**
+   * @brief Parameterized constructor.
+   *
+   * @param px The X-coordinate.
+   * @param py The Y-coordinate.
+   */
+  Point(double px, double py) : x(px), y(py) {}
+};
+
+/**
+ * @brief Calculates the Euclidean distance between two points.
+ *
+ * @param a The first point.
+ * @param b The second point.
+ * @return The Euclidean distance between a and b.
+ */
+inline double CalculateDistance(const Point &a, const Point &b) {
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+#endif
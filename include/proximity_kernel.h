@@ -0,0 +1,77 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_PROXIMITY_KERNEL_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_PROXIMITY_KERNEL_H_
+
+#include <cstddef>
+
+#include "point.h"
+
+/**
+ * @brief Instruction sets the proximity kernel can be compiled for.
+ */
+enum class ProximityIsa {
+  kScalar, /**< Portable C++ loop. */
+  kSse2,   /**< Two riders per instruction (x86-64 baseline). */
+  kAvx2    /**< Four riders per instruction. */
+};
+
+/**
+ * @brief Signature shared by every implementation of the proximity kernel.
+ *
+ * Checks a candidate request against `count` riders whose coordinates are
+ * given as separate arrays (structure of arrays). Returns true if, for every
+ * rider, both the candidate's origin lies within `max_distance` of the rider's
+ * origin and the candidate's destination lies within `max_distance` of the
+ * rider's destination (Constraint 2 of the grouping heuristic).
+ *
+ * Squared distances are compared against `max_distance_sq`, so no square root
+ * is taken. This only differs from comparing `sqrt(d2) > max_distance` when a
+ * distance equals `max_distance` to within rounding.
+ *
+ * A negative `max_distance_sq` rejects every pair, since no squared distance
+ * lies below it. Callers pass a negative limit for a negative `max_distance`,
+ * which no distance can satisfy, rather than its square.
+ */
+typedef bool (*ProximityKernel)(const double *origin_x, const double *origin_y,
+                                const double *dest_x, const double *dest_y,
+                                size_t count, Point origin, Point dest,
+                                double max_distance_sq);
+
+/**
+ * @brief Checks Constraint 2 with the best kernel for the running CPU.
+ *
+ * The implementation is selected once, on the first call, by querying the
+ * CPU for AVX2 support; SSE2 is used otherwise on x86-64, and the scalar loop
+ * on any other architecture.
+ *
+ * @param origin_x X-coordinates of the riders' origins.
+ * @param origin_y Y-coordinates of the riders' origins.
+ * @param dest_x X-coordinates of the riders' destinations.
+ * @param dest_y Y-coordinates of the riders' destinations.
+ * @param count Number of riders.
+ * @param origin Origin of the candidate request.
+ * @param dest Destination of the candidate request.
+ * @param max_distance_sq The square of the maximum allowed distance.
+ * @return true if the candidate is close enough to every rider.
+ */
+bool AllWithinDistance(const double *origin_x, const double *origin_y,
+                       const double *dest_x, const double *dest_y,
+                       size_t count, Point origin, Point dest,
+                       double max_distance_sq);
+
+/**
+ * @brief Gets the kernel compiled for a specific instruction set.
+ *
+ * Used by benchmarks to compare implementations.
+ *
+ * @param isa The desired instruction set.
+ * @return The kernel, or nullptr if it is unavailable on this CPU or build.
+ */
+ProximityKernel GetProximityKernel(ProximityIsa isa);
+
+/**
+ * @brief Gets the instruction set chosen by `AllWithinDistance`.
+ * @return The best supported instruction set.
+ */
+ProximityIsa GetBestProximityIsa();
+
+#endif
@@ -1,9 +1,13 @@
 #ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_REQUEST_H_
 #define RIDE_DISPATCH_SIMULATOR_INCLUDE_REQUEST_H_
 
+#include <cstddef>
 #include <string>
 
+#include "point.h"
+
 class Ride;
+class RequestTable;
 
 /**
  * @brief Represents the lifecycle states of a ride request.
@@ -21,33 +25,35 @@ enum RequestState {
  * Encapsulates all details regarding a ride request, including origin,
  * destination, timestamp, and its current processing state within the dispatch
  * system. It acts as the primary data unit for the scheduling algorithm.
+ *
+ * A Request is a lightweight view over one row of a RequestTable: the ID,
+ * time and coordinates live in the table's contiguous columns, and only the
+ * processing state is stored in the object itself. Getters and setters read
+ * and write through to the table.
  */
 class Request {
 private:
-  std::string id_;          // Unique identifier for the request.
-  long request_time_;       // Timestamp of when the request was placed.
-  std::string origin_;      // Starting coordinates.
-  std::string destination_; // Ending coordinates.
-  RequestState state_;      // Current status of the request.
-  Ride *associated_ride_;   // Pointer to the ride fulfilling this request.
+  RequestTable *table_;   // Table holding the request's data.
+  size_t row_;            // Row of the request in table_.
+  RequestState state_;    // Current status of the request.
+  Ride *associated_ride_; // Pointer to the ride fulfilling this request.
 
 public:
   /**
    * @brief Default constructor.
    *
-   * Initializes a request with default values and state set to kRequested.
+   * Initializes a request that is not bound to any table, with state set to
+   * kRequested. It must be bound to a row before its data is accessed.
    */
   Request();
 
   /**
    * @brief Parameterized constructor.
    *
-   * @param id Unique identifier for the request.
-   * @param time Timestamp of the request.
-   * @param origin Origin coordinates as a string.
-   * @param dest Destination coordinates as a string.
+   * @param table The table holding the request's data.
+   * @param row The row of the request in the table.
    */
-  Request(std::string id, long time, std::string origin, std::string dest);
+  Request(RequestTable *table, size_t row);
 
   /**
    * @brief Destructor.
@@ -56,10 +62,31 @@ public:
 
   /**
    * @brief Gets the unique identifier of the request.
-   * @return The request ID.
+   * @return A copy of the request ID.
    */
   std::string GetId() const;
 
+  /**
+   * @brief Gets a pointer to the characters of the request ID.
+   *
+   * The characters are not null-terminated; use `GetIdLength` for the size.
+   *
+   * @return Pointer to the first character of the ID.
+   */
+  const char *GetIdData() const;
+
+  /**
+   * @brief Gets the number of characters in the request ID.
+   * @return The ID length.
+   */
+  size_t GetIdLength() const;
+
+  /**
+   * @brief Gets the row of the request in its table.
+   * @return The row index.
+   */
+  size_t GetRow() const;
+
   /**
    * @brief Gets the timestamp when the request was made.
    * @return The request time.
@@ -68,15 +95,24 @@ public:
 
   /**
    * @brief Gets the origin coordinates.
-   * @return The origin string.
+   * @return The origin point.
    */
-  std::string GetOrigin() const;
+  Point GetOrigin() const;
 
   /**
    * @brief Gets the destination coordinates.
-   * @return The destination string.
+   * @return The destination point.
+   */
+  Point GetDestination() const;
+
+  /**
+   * @brief Gets the distance from the origin to the destination.
+   *
+   * Computed once when the request is loaded.
+   *
+   * @return The direct distance.
    */
-  std::string GetDestination() const;
+  double GetDirectDistance() const;
 
   /**
    * @brief Gets the current state of the request.
@@ -104,15 +140,15 @@ public:
 
   /**
    * @brief Sets the origin coordinates.
-   * @param origin The new origin string.
+   * @param origin The new origin point.
    */
-  void SetOrigin(std::string origin);
+  void SetOrigin(Point origin);
 
   /**
    * @brief Sets the destination coordinates.
-   * @param dest The new destination string.
+   * @param dest The new destination point.
    */
-  void SetDestination(std::string dest);
+  void SetDestination(Point dest);
 
   /**
    * @brief Associates a ride with this request.
@@ -0,0 +1,196 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_REQUEST_TABLE_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_REQUEST_TABLE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "point.h"
+#include "vector.h"
+
+/**
+ * @brief Columnar storage for every request read from the input.
+ *
+ * Instead of one heap object per request, each field is stored in its own
+ * contiguous array (structure of arrays), indexed by the request's row. IDs
+ * are packed back to back in a single character pool, with offset and length
+ * arrays marking where each one lies.
+ *
+ * The table is filled directly by the InputReader, without creating any
+ * intermediate strings. The direct distance of each request is computed once
+ * when its row is appended, since grouping needs it for every candidate.
+ *
+ * The row getters sit on the grouping hot path and do not check their row
+ * argument, which must be below size(); checked builds verify it with
+ * DEBUG_CHECK.
+ */
+class RequestTable {
+private:
+  Vector<long> times_;        // Request timestamps.
+  Vector<double> origin_x_;   // X-coordinates of the origins.
+  Vector<double> origin_y_;   // Y-coordinates of the origins.
+  Vector<double> dest_x_;     // X-coordinates of the destinations.
+  Vector<double> dest_y_;     // Y-coordinates of the destinations.
+  Vector<double> direct_;     // Origin-destination distance of each request.
+  Vector<size_t> id_starts_;  // Offset of each ID in id_chars_.
+  Vector<size_t> id_lengths_; // Number of characters of each ID.
+  Vector<char> id_chars_;     // All IDs, concatenated.
+
+  /**
+   * @brief Appends ID characters to the pool.
+   * @param id Pointer to the characters.
+   * @param id_length Number of characters.
+   * @return The offset of the first appended character.
+   */
+  size_t AppendIdChars(const char *id, size_t id_length);
+
+public:
+  /**
+   * @brief Default constructor.
+   *
+   * Initializes an empty table.
+   */
+  RequestTable();
+
+  /**
+   * @brief Appends a request as a new row.
+   *
+   * @param id Pointer to the characters of the request ID.
+   * @param id_length Number of characters in the ID.
+   * @param time Timestamp of the request.
+   * @param origin Origin coordinates.
+   * @param dest Destination coordinates.
+   * @return The row index of the new request.
+   */
+  size_t Append(const char *id, size_t id_length, long time, Point origin,
+                Point dest);
+
+  /**
+   * @brief Preallocates every column for a number of rows.
+   * @param rows The number of rows to make room for.
+   */
+  void reserve(size_t rows);
+
+  /**
+   * @brief Removes every row.
+   *
+   * Logical clear; does not deallocate internal memory.
+   */
+  void clear();
+
+  /**
+   * @brief Gets the number of requests in the table.
+   * @return The number of rows.
+   */
+  size_t size() const;
+
+  /**
+   * @brief Gets the ID of a request as a string.
+   * @param row The row index.
+   * @return A copy of the request ID.
+   */
+  std::string GetId(size_t row) const;
+
+  /**
+   * @brief Gets a pointer to the characters of a request ID.
+   *
+   * The characters are not null-terminated; use `GetIdLength` for the size.
+   *
+   * @param row The row index.
+   * @return Pointer to the first character of the ID.
+   */
+  const char *GetIdData(size_t row) const;
+
+  /**
+   * @brief Gets the number of characters in a request ID.
+   * @param row The row index.
+   * @return The ID length.
+   */
+  size_t GetIdLength(size_t row) const;
+
+  /**
+   * @brief Gets the timestamp of a request.
+   * @param row The row index.
+   * @return The request time.
+   */
+  long GetTime(size_t row) const;
+
+  /**
+   * @brief Gets the origin of a request.
+   * @param row The row index.
+   * @return The origin point.
+   */
+  Point GetOrigin(size_t row) const;
+
+  /**
+   * @brief Gets the destination of a request.
+   * @param row The row index.
+   * @return The destination point.
+   */
+  Point GetDestination(size_t row) const;
+
+  /**
+   * @brief Gets the distance from the origin to the destination of a request.
+   * @param row The row index.
+   * @return The direct distance.
+   */
+  double GetDirectDistance(size_t row) const;
+
+  /**
+   * @brief Gets the contiguous column of origin X-coordinates.
+   * @return Pointer to the X-coordinate of row 0.
+   */
+  const double *GetOriginXData() const;
+
+  /**
+   * @brief Gets the contiguous column of origin Y-coordinates.
+   * @return Pointer to the Y-coordinate of row 0.
+   */
+  const double *GetOriginYData() const;
+
+  /**
+   * @brief Gets the contiguous column of destination X-coordinates.
+   * @return Pointer to the X-coordinate of row 0.
+   */
+  const double *GetDestXData() const;
+
+  /**
+   * @brief Gets the contiguous column of destination Y-coordinates.
+   * @return Pointer to the Y-coordinate of row 0.
+   */
+  const double *GetDestYData() const;
+
+  /**
+   * @brief Replaces the ID of a request.
+   *
+   * The new characters are appended to the pool; the old ones are not
+   * reclaimed.
+   *
+   * @param row The row index.
+   * @param id Pointer to the characters of the new ID.
+   * @param id_length Number of characters in the new ID.
+   */
+  void SetId(size_t row, const char *id, size_t id_length);
+
+  /**
+   * @brief Sets the timestamp of a request.
+   * @param row The row index.
+   * @param time The new request time.
+   */
+  void SetTime(size_t row, long time);
+
+  /**
+   * @brief Sets the origin of a request.
+   * @param row The row index.
+   * @param origin The new origin point.
+   */
+  void SetOrigin(size_t row, Point origin);
+
+  /**
+   * @brief Sets the destination of a request.
+   * @param row The row index.
+   * @param dest The new destination point.
+   */
+  void SetDestination(size_t row, Point dest);
+};
+
+#endif
@@ -1,13 +1,34 @@
 #ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_RIDE_H_
 #define RIDE_DISPATCH_SIMULATOR_INCLUDE_RIDE_H_
 
+#include <cstddef>
 #include <string>
 
 #include "segment.h"
-#include "vector.h"
 
+class Arena;
 class Request;
 
+/**
+ * @brief The outcome of evaluating the insertion of a request into a ride.
+ *
+ * Produced by `Ride::EvaluateInsertion` and consumed by
+ * `Ride::CommitInsertion`. It carries the running sums the ride would hold
+ * after the insertion and the new legs of the route, so neither committing nor
+ * rebuilding the route recomputes any distance.
+ */
+struct InsertionResult {
+  double sum_direct;     /**< Sum of the direct distances of all requests. */
+  double pickup_chain;   /**< Length of the path through all pickups. */
+  double dropoff_chain;  /**< Length of the path through all drop-offs. */
+  double pickup_leg;     /**< Leg from the last pickup to the new one. */
+  double dropoff_leg;    /**< Leg from the last drop-off to the new one. */
+  double displacement;   /**< Leg from the new pickup to the first drop-off. */
+  double route_distance; /**< Total route distance after the insertion. */
+  double distance_delta; /**< Increase of the route distance. */
+  double efficiency;     /**< Efficiency of the ride after the insertion. */
+};
+
 /**
  * @brief Represents a ride in the dispatch system.
  *
@@ -19,18 +40,89 @@ class Request;
  * metrics (distance, duration), and evaluating the efficiency of the ride,
  * which is a key metric for the ride-sharing algorithm.
  *
- * It utilizes a custom `Vector` implementation for dynamic array management,
- * adhering to the project's constraint of avoiding STL containers.
+ * Its requests, stops, segment pointers and legs are kept in slot arrays, the
+ * stops by value. A plain Ride has no limit on its requests: its slots live on
+ * the heap and double whenever they are full, like a `Vector`. `FixedRide`
+ * keeps a fixed number of slots inline instead.
  */
 class Ride {
 private:
-  Vector<Request *> requests_; // List of requests satisfied by this ride.
-  Vector<Segment *> segments_; // Sequence of segments forming the route.
+  Request **requests_; // Requests satisfied by this ride.
+  Stop *stops_;        // Stops visited by the route, in order.
+  Segment **segments_; // Sequence of segments forming the route.
+  size_t slots_;       // Number of request slots.
+  int request_count_;  // Number of requests in the ride.
+  int stop_count_;     // Number of stops in the route.
+  int segment_count_;  // Number of segments in the route.
+  bool grows_;         // Whether the slots are on the heap and can grow.
+  Arena *arena_;       // Arena that owns the segments, or nullptr for heap.
 
   double total_distance_; // Total distance of the ride in spatial units.
   double total_duration_; // Total duration of the ride in time units.
   double efficiency_;     // Efficiency score (0.0 to 1.0).
 
+  // Running sums kept up to date on every insertion, so that a candidate can
+  // be evaluated in O(1) without rebuilding the route.
+  double sum_direct_;     // Sum of the direct distances of all requests.
+  double pickup_chain_;   // Length of the path through all pickups in order.
+  double dropoff_chain_;  // Length of the path through all drop-offs in order.
+  double route_distance_; // pickup_chain_ + displacement_ + dropoff_chain_.
+
+  // Distances between consecutive stops, filled as requests are appended, so
+  // that `UpdateRoute` builds the segments without recomputing them.
+  double *pickup_legs_;  // Leg i joins pickups i and i + 1.
+  double *dropoff_legs_; // Leg i joins drop-offs i and i + 1.
+  double displacement_;  // Leg from the last pickup to the first drop-off.
+
+  /**
+   * @brief Resets the ride to an empty state over the given slots.
+   */
+  void Init(Arena *arena, size_t slots, Request **requests, Stop *stops,
+            Segment **segments, double *legs);
+
+  /**
+   * @brief Doubles the slots of a growing ride, keeping their contents.
+   *
+   * The current segments are pointed at the moved stops.
+   *
+   * @throws std::length_error If the ride has fixed slots.
+   */
+  void GrowSlots();
+
+  /**
+   * @brief Discards the current stops and segments.
+   *
+   * Frees the segments when the ride does not use an arena, and resets the
+   * total distance and duration.
+   */
+  void ClearRoute();
+
+  /**
+   * @brief Appends a stop to the route's stops.
+   * @param request The request of the passenger associated with the stop.
+   * @param type The type of the stop.
+   * @return Pointer to the new Stop, in the stop slots.
+   */
+  Stop *NewStop(const Request *request, StopType type);
+
+  // Copying is not supported.
+  Ride(const Ride &);
+  Ride &operator=(const Ride &);
+
+protected:
+  /**
+   * @brief Slot constructor, for rides that provide their own fixed slots.
+   *
+   * @param arena The arena to allocate segments from, or nullptr.
+   * @param slots The number of request slots (at least 1).
+   * @param requests `slots` request slots.
+   * @param stops `2 * slots` stop slots.
+   * @param segments `2 * slots - 1` segment slots.
+   * @param legs `2 * slots - 2` leg slots (at least 1).
+   */
+  Ride(Arena *arena, size_t slots, Request **requests, Stop *stops,
+       Segment **segments, double *legs);
+
 public:
   /**
    * @brief Default constructor.
@@ -40,25 +132,66 @@ public:
    */
   Ride();
 
+  /**
+   * @brief Arena constructor.
+   *
+   * Initializes an empty Ride whose segments are allocated from the given
+   * arena. They are reclaimed when the arena is released rather than by this
+   * ride.
+   *
+   * @param arena The arena to allocate segments from.
+   */
+  explicit Ride(Arena *arena);
+
   /**
    * @brief Destructor.
    *
-   * Responsible for freeing the memory allocated for segments. Note that it
-   * does NOT own the Request objects, so they are not deleted here.
+   * Responsible for freeing the memory allocated for segments, unless they
+   * belong to an arena. Note that it does NOT own the Request objects, so
+   * they are not deleted here.
    */
   ~Ride();
 
   /**
    * @brief Adds a request to the ride.
    *
-   * Appends a new request to the list of requests served by this ride.
-   * Note that this does not automatically update the route; `UpdateRoute` must
-   * be called subsequently to regenerate the segments.
+   * Appends a new request to the list of requests served by this ride and
+   * updates the running route sums. Note that this does not automatically
+   * update the route; `UpdateRoute` must be called subsequently to regenerate
+   * the segments.
    *
    * @param request Pointer to the Request object to be added.
+   * @throws std::length_error If the ride has fixed slots and is full.
    */
   void AddRequest(Request *request);
 
+  /**
+   * @brief Evaluates appending a request to the ride without modifying it.
+   *
+   * The route visits all pickups in order and then all drop-offs in order, so
+   * appending a request only extends the pickup chain by one leg, extends the
+   * drop-off chain by one leg, and replaces the displacement leg between the
+   * last pickup and the first drop-off. Using the cached running sums, this
+   * costs O(1) and performs no allocation.
+   *
+   * @param request Pointer to the candidate Request.
+   * @return The route metrics the ride would have after the insertion.
+   */
+  InsertionResult EvaluateInsertion(const Request *request) const;
+
+  /**
+   * @brief Appends a request using a previously computed evaluation.
+   *
+   * Updates the running sums and the efficiency from `result`. As with
+   * `AddRequest`, the segments are not regenerated; `UpdateRoute` must be
+   * called once the ride is complete.
+   *
+   * @param request Pointer to the Request object to be added.
+   * @param result The evaluation returned by `EvaluateInsertion(request)`.
+   * @throws std::length_error If the ride has fixed slots and is full.
+   */
+  void CommitInsertion(Request *request, const InsertionResult &result);
+
   /**
    * @brief Adds a segment to the ride's route.
    *
@@ -66,7 +199,10 @@ public:
    * duration of the ride.
    *
    * @param segment Pointer to the Segment object to be added. The Ride takes
-   * ownership of this segment.
+   * ownership of this segment, unless the ride draws from an arena, in which
+   * case the segment must have been allocated from that arena.
+   * @throws std::length_error If the ride has fixed slots and every segment
+   * slot is taken.
    */
   void AddSegment(Segment *segment);
 
@@ -77,6 +213,9 @@ public:
    * all individual requests to the total distance of the combined ride.
    *
    * Formula: Efficiency = (Sum of direct distances) / (Total ride distance)
+   *
+   * The sum of direct distances is taken from the running sum maintained by
+   * `AddRequest` and `CommitInsertion`.
    */
   void CalculateEfficiency();
 
@@ -86,8 +225,10 @@ public:
    *
    * This method clears the existing segments and creates a new sequence of
    * segments that visits all pickup locations followed by all drop-off
-   * locations in the order the requests were added. It also recalculates the
-   * total distance, duration, and efficiency.
+   * locations in the order the requests were added. The segment distances are
+   * the legs cached by `CommitInsertion`. It also recalculates the total
+   * distance, duration, and efficiency. When the ride uses an arena, the
+   * previous segments stay allocated until the arena is released.
    *
    * @param speed The speed of the vehicle, used to calculate segment durations.
    */
@@ -107,6 +248,26 @@ public:
    */
   std::string GetDemandId(int index) const;
 
+  /**
+   * @brief Gets a specific request served by this ride.
+   *
+   * Gives direct access to the request objects so callers do not have to look
+   * them up again by ID.
+   *
+   * @param index The index of the request.
+   * @return Pointer to the Request, or nullptr if index is invalid.
+   */
+  Request *GetRequest(int index) const;
+
+  /**
+   * @brief Gets the first request of the ride.
+   *
+   * The first request defines the start time of the ride.
+   *
+   * @return Pointer to the first Request, or nullptr if the ride is empty.
+   */
+  Request *GetFirstRequest() const;
+
   /**
    * @brief Gets the number of segments in the ride's route.
    * @return The count of segments.
@@ -126,6 +287,16 @@ public:
    */
   double GetTotalDistance() const;
 
+  /**
+   * @brief Gets the route distance tracked by the running sums.
+   *
+   * Unlike `GetTotalDistance`, this value is current after every insertion,
+   * even before `UpdateRoute` has regenerated the segments.
+   *
+   * @return The route distance.
+   */
+  double GetRouteDistance() const;
+
   /**
    * @brief Gets the total duration of the ride.
    * @return The total duration.
@@ -145,4 +316,33 @@ public:
   void SetEfficiency(double eff);
 };
 
+/**
+ * @brief A Ride whose slots are arrays inside the object itself.
+ *
+ * With the maximum number of requests known at compile time, creating the
+ * ride is a single allocation and its slots share the ride's cache lines.
+ * The slots never grow: appending beyond them throws.
+ *
+ * @tparam kMaxRequests The maximum number of requests (at least 1).
+ */
+template <int kMaxRequests> class FixedRide : public Ride {
+private:
+  static_assert(kMaxRequests >= 1, "A ride holds at least one request");
+  static const int kLegSlots = (kMaxRequests > 1) ? 2 * kMaxRequests - 2 : 1;
+
+  Request *request_slots_[kMaxRequests];
+  Stop stop_slots_[2 * kMaxRequests];
+  Segment *segment_slots_[2 * kMaxRequests - 1];
+  double leg_slots_[kLegSlots];
+
+public:
+  /**
+   * @brief Constructor.
+   * @param arena The arena to allocate segments from, or nullptr.
+   */
+  explicit FixedRide(Arena *arena)
+      : Ride(arena, kMaxRequests, request_slots_, stop_slots_, segment_slots_,
+             leg_slots_) {}
+};
+
 #endif
@@ -0,0 +1,96 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_SIMULATION_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_SIMULATION_H_
+
+#include "vector.h"
+
+class OutputWriter;
+class Ride;
+
+/**
+ * @brief Priority queues available to the event scheduler (Phase 3).
+ */
+enum class EventQueueKind {
+  kBinaryHeap,     /**< MinHeap with 2 children per node. */
+  kQuaternaryHeap, /**< MinHeap with 4 children per node. */
+  kOctonaryHeap,   /**< MinHeap with 8 children per node. */
+  kCalendar        /**< CalendarQueue, O(1) amortized per event. */
+};
+
+/**
+ * @brief How the event scheduler advances the rides (Phases 2 and 3).
+ */
+enum class SimulationMode {
+  kPerSegment, /**< One event per segment of every ride. */
+  kFast        /**< One event per ride, at its computed completion time. */
+};
+
+/**
+ * @brief Measurements of Phases 2 and 3, filled in on request.
+ */
+struct SimulationCounters {
+  double schedule_seconds;   /**< Wall time of Phase 2. */
+  double simulate_seconds;   /**< Wall time of Phase 3, output included. */
+  unsigned long long events; /**< Events processed in Phase 3. */
+  size_t max_queue_size;     /**< Most events pending at once. */
+
+  /**
+   * @brief Default constructor.
+   *
+   * Zeroes every measurement.
+   */
+  SimulationCounters()
+      : schedule_seconds(0), simulate_seconds(0), events(0),
+        max_queue_size(0) {}
+};
+
+/**
+ * @brief Writes the details of a completed ride as one output line.
+ *
+ * The line holds the completion time, the total distance, the number of stops
+ * and the coordinates of every stop.
+ *
+ * @param r The completed ride.
+ * @param output The output to write to.
+ */
+void WriteRide(const Ride *r, OutputWriter &output);
+
+/**
+ * @brief Computes the time at which a ride reaches its last stop.
+ *
+ * The segment times are added to the start time one by one, in the same order
+ * and precision as the per-segment events, so the result equals the time of
+ * the ride's last event exactly.
+ *
+ * @param r The ride, with its route built.
+ * @return The completion time.
+ */
+double GetCompletionTime(const Ride *r);
+
+/**
+ * @brief Runs the discrete event simulation of the formed rides.
+ *
+ * In kPerSegment mode, Phase 2 schedules the first event of every ride at the
+ * time of its first request. Phase 3 then processes the events in
+ * chronological order: each one moves its ride along the next segment of the
+ * route, and when a ride has no segment left its details are written to the
+ * output.
+ *
+ * In kFast mode, Phase 2 computes the completion time of every ride from its
+ * segments and schedules a single event there, and Phase 3 writes the rides as
+ * their events are popped. Since nothing observes the intermediate stops, the
+ * output is the same as in kPerSegment mode, with 2 * capacity times fewer
+ * queue operations for full rides.
+ *
+ * @param mode How the rides are advanced.
+ * @param queue_kind The priority queue holding the pending events.
+ * @param rides The rides to simulate.
+ * @param output Receives one line per completed ride.
+ * @param[out] counters If not null, receives the phase timings and the
+ * number of events.
+ * @throws std::length_error If there are more than kMaxEventRides rides.
+ */
+void SimulateRides(SimulationMode mode, EventQueueKind queue_kind,
+                   const Vector<Ride *> &rides, OutputWriter &output,
+                   SimulationCounters *counters = nullptr);
+
+#endif
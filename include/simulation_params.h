@@ -0,0 +1,18 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_SIMULATION_PARAMS_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_SIMULATION_PARAMS_H_
+
+/**
+ * @brief Holds the configuration parameters for the simulation.
+ *
+ * These values are read from the first line of the input.
+ */
+struct SimulationParams {
+  int capacity;         /**< Maximum number of passengers per vehicle. */
+  double speed;         /**< Vehicle speed in distance units per time unit. */
+  double max_wait_time; /**< Maximum allowed wait time for a passenger. */
+  double max_delay;     /**< Maximum allowed delay for a passenger. */
+  double max_distance; /**< Maximum distance between combined request points. */
+  double min_efficiency; /**< Minimum required efficiency for a shared ride. */
+};
+
+#endif
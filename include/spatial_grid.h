@@ -0,0 +1,105 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_SPATIAL_GRID_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_SPATIAL_GRID_H_
+
+#include <cstddef>
+
+#include "point.h"
+#include "vector.h"
+
+/**
+ * @brief Uniform grid index over request rows, keyed by location.
+ *
+ * The plane is divided into square cells of a fixed size, and every inserted
+ * row is appended to the bucket of the cell containing its point. Only cells
+ * that hold rows are materialized; they are found through an open-addressing
+ * hash table keyed by the cell coordinates.
+ *
+ * With the cell size equal to the grouping `max_distance`, every point within
+ * that distance of a query point lies in the query cell or one of its eight
+ * neighbors, so a neighborhood lookup costs O(1) expected time plus the
+ * number of rows returned.
+ */
+class SpatialGrid {
+private:
+  /**
+   * @brief The rows stored in one cell, in insertion order.
+   */
+  struct Bucket {
+    long long cell_x;    // Cell X-coordinate of the bucket.
+    long long cell_y;    // Cell Y-coordinate of the bucket.
+    Vector<size_t> rows; // Rows in this cell, in ascending order.
+  };
+
+  double cell_size_;         // Side length of a cell.
+  Vector<Bucket *> buckets_; // Every materialized cell.
+  int *slots_;               // Hash table of indices into buckets_.
+  size_t slot_count_;        // Number of slots (always a power of two).
+
+  /**
+   * @brief Computes the cell coordinate containing a coordinate value.
+   * @param value The coordinate.
+   * @return The cell coordinate.
+   */
+  long long CellOf(double value) const;
+
+  /**
+   * @brief Finds the hash slot of a cell, or the empty slot where it belongs.
+   * @param cell_x The cell X-coordinate.
+   * @param cell_y The cell Y-coordinate.
+   * @return The slot index.
+   */
+  size_t Probe(long long cell_x, long long cell_y) const;
+
+  /**
+   * @brief Grows the hash table and reinserts every bucket.
+   * @param new_slot_count The new number of slots (a power of two).
+   */
+  void Rehash(size_t new_slot_count);
+
+  // Copying is not supported.
+  SpatialGrid(const SpatialGrid &);
+  SpatialGrid &operator=(const SpatialGrid &);
+
+public:
+  /**
+   * @brief Constructor.
+   *
+   * @param cell_size The side length of a cell. Non-positive values are
+   * replaced by 1.
+   */
+  explicit SpatialGrid(double cell_size);
+
+  /**
+   * @brief Destructor.
+   *
+   * Frees every bucket and the hash table.
+   */
+  ~SpatialGrid();
+
+  /**
+   * @brief Inserts a row at a location.
+   *
+   * Rows must be inserted in ascending order.
+   *
+   * @param row The row to insert.
+   * @param point The location of the row.
+   */
+  void Insert(size_t row, Point point);
+
+  /**
+   * @brief Collects the live rows in the 3x3 cell neighborhood of a point.
+   *
+   * Rows below `min_row` or flagged in `removed` are dropped from their
+   * buckets permanently while scanning, so each stale row is visited at most
+   * once.
+   *
+   * @param point The query location.
+   * @param min_row Rows below this value are considered stale.
+   * @param removed Per-row flags; non-zero marks a stale row.
+   * @param[out] rows Receives the live rows, in ascending order.
+   */
+  void QueryNeighborhood(Point point, size_t min_row,
+                         const Vector<char> &removed, Vector<size_t> &rows);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_STATS_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_STATS_H_
+
+#include <chrono>
+#include <cstddef>
+
+#include "grouping.h"
+#include "simulation.h"
+#include "vector.h"
+
+class Ride;
+
+/**
+ * @brief Measures the wall time of consecutive phases.
+ */
+class Stopwatch {
+private:
+  std::chrono::steady_clock::time_point start_; // Start of the current lap.
+
+public:
+  /**
+   * @brief Constructor. Starts the first lap.
+   */
+  Stopwatch() : start_(std::chrono::steady_clock::now()) {}
+
+  /**
+   * @brief Ends the current lap and starts the next one.
+   * @return The seconds elapsed since the start of the lap.
+   */
+  double Lap() {
+    std::chrono::steady_clock::time_point now =
+        std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - start_).count();
+    start_ = now;
+    return seconds;
+  }
+};
+
+/**
+ * @brief Runtime statistics of a whole run, reported with `--stats`.
+ *
+ * Gathers the measurements of every phase: the constraint rejections of
+ * Phase 1 (GroupingStats), the events and timings of Phases 2 and 3
+ * (SimulationCounters), the ride sizes and the time spent reading the input
+ * and writing the output. Collecting them costs a null pointer check per
+ * rejection and a few clock reads per phase, so runs without `--stats`
+ * (which pass no statistics) are unaffected.
+ */
+struct RunStats {
+  size_t requests;                       /**< Requests read. */
+  double read_seconds;                   /**< Wall time of reading. */
+  double group_seconds;                  /**< Wall time of Phase 1. */
+  double output_seconds;                 /**< Wall time of the last flush. */
+  GroupingStats grouping;                /**< Phase 1 rejections. */
+  SimulationCounters simulation;         /**< Phases 2 and 3. */
+  Vector<unsigned long long> ride_sizes; /**< Rides by number of riders. */
+
+  /**
+   * @brief Default constructor.
+   *
+   * Zeroes every measurement.
+   */
+  RunStats()
+      : requests(0), read_seconds(0), group_seconds(0), output_seconds(0) {}
+
+  /**
+   * @brief Adds formed rides to the ride size histogram.
+   * @param rides The rides.
+   */
+  void RecordRides(const Vector<Ride *> &rides);
+
+  /**
+   * @brief Gets the number of rides recorded in the histogram.
+   * @return The number of rides.
+   */
+  unsigned long long GetRideCount() const;
+
+  /**
+   * @brief Prints the statistics to stderr.
+   */
+  void Print() const;
+};
+
+#endif
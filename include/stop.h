@@ -3,6 +3,10 @@
 
 #include <string>
 
+#include "point.h"
+
+class Request;
+
 /**
  * @brief Enumerates the possible types of stops in a ride.
  *
@@ -19,22 +23,25 @@ enum class StopType {
  *
  * A Stop encapsulates the essential details of a visit to a location: the
  * spatial coordinates, the nature of the action (pickup or drop-off), and the
- * identifier of the passenger associated with this action.
+ * request of the passenger associated with this action.
+ *
+ * The coordinates and the passenger ID are read from the request, which the
+ * stop refers to, so a stop is two words that own no memory and rides can
+ * keep their stops in plain arrays.
  *
  * This class serves as a node in the route graph, defining the sequence of
  * operations a vehicle must perform.
  */
 class Stop {
 private:
-  std::string coordinate_; // The location identifier or coordinate.
+  const Request *request_; // Request of the passenger, or nullptr.
   StopType type_;          // The type of operation at this stop.
-  std::string passenger_id_;
 
 public:
   /**
    * @brief Default constructor.
    *
-   * Initializes a Stop with empty coordinate/passenger ID and default type.
+   * Initializes a Stop at the origin with no request and default type.
    */
   Stop();
 
@@ -43,22 +50,17 @@ public:
    *
    * Creates a fully initialized Stop.
    *
-   * @param coord The string representation of the coordinate.
+   * @param request The request of the passenger.
    * @param t The type of the stop (kPickup or kDropoff).
-   * @param pid The unique identifier of the passenger.
-   */
-  Stop(std::string coord, StopType t, std::string pid);
-
-  /**
-   * @brief Destructor.
    */
-  ~Stop();
+  Stop(const Request *request, StopType t);
 
   /**
    * @brief Gets the coordinate of the stop.
-   * @return The coordinate string.
+   * @return The origin of the request for a pickup, its destination for a
+   * drop-off, or the origin of the plane if no request is set.
    */
-  std::string GetCoordinate() const;
+  Point GetCoordinate() const;
 
   /**
    * @brief Gets the type of the stop.
@@ -67,16 +69,16 @@ public:
   StopType GetType() const;
 
   /**
-   * @brief Gets the ID of the passenger associated with this stop.
-   * @return The passenger ID string.
+   * @brief Gets the request of the passenger associated with this stop.
+   * @return Pointer to the Request, or nullptr if none is set.
    */
-  std::string GetPassengerId() const;
+  const Request *GetRequest() const;
 
   /**
-   * @brief Sets the coordinate of the stop.
-   * @param coord The new coordinate string.
+   * @brief Gets the ID of the passenger associated with this stop.
+   * @return The passenger ID string, or an empty string if no request is set.
    */
-  void SetCoordinate(std::string coord);
+  std::string GetPassengerId() const;
 
   /**
    * @brief Sets the type of the stop.
@@ -85,10 +87,10 @@ public:
   void SetType(StopType t);
 
   /**
-   * @brief Sets the passenger ID for this stop.
-   * @param pid The new passenger ID string.
+   * @brief Sets the request of the passenger for this stop.
+   * @param request The new request.
    */
-  void SetPassengerId(std::string pid);
+  void SetRequest(const Request *request);
 };
 
 #endif
@@ -0,0 +1,43 @@
+#ifndef RIDE_DISPATCH_SIMULATOR_INCLUDE_STREAMING_H_
+#define RIDE_DISPATCH_SIMULATOR_INCLUDE_STREAMING_H_
+
+#include <cstddef>
+
+#include "options.h"
+
+class InputReader;
+class OutputWriter;
+struct RunStats;
+struct SimulationParams;
+
+/**
+ * @brief Runs all three phases over the request stream in bounded memory.
+ *
+ * Requests are read in fixed-size batches. Each batch is grouped on its own,
+ * except for the rides that could still take requests of the next batch
+ * (see GroupRequests), whose requests are carried over to it. Every formed
+ * ride is scheduled at its completion time, as in SimulationMode::kFast.
+ *
+ * A ride formed later starts no earlier than the first request that is not
+ * yet grouped, so every ride completing up to that time is written out right
+ * away. A batch is freed as soon as all of its rides are written; memory is
+ * thus proportional to the rides still in progress rather than to the whole
+ * input, and the output is identical to a run over the whole input.
+ *
+ * Requests must be in non-decreasing time order, as in the input format.
+ *
+ * @param options The grouping strategy and event queue to use.
+ * @param params The simulation parameters.
+ * @param reader The input, positioned at the first request.
+ * @param count The number of requests announced by the input.
+ * @param output Receives one line per completed ride.
+ * @param[out] stats If not null, receives the statistics of the run, with
+ * the time of each phase summed over the batches.
+ * @throws std::length_error If there are more than kMaxEventRides rides.
+ */
+void SimulateStream(const SimulationOptions &options,
+                    const SimulationParams &params, InputReader &reader,
+                    size_t count, OutputWriter &output,
+                    RunStats *stats = nullptr);
+
+#endif
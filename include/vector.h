@@ -2,7 +2,14 @@
 #define RIDE_DISPATCH_SIMULATOR_INCLUDE_VECTOR_H_
 
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "debug_check.h"
 
 /**
  * @brief A dynamic array implementation that manages memory manually.
@@ -12,33 +19,130 @@
  * project's constraint of avoiding STL containers. It supports dynamic
  * resizing, random access, and automatic memory management.
  *
+ * Storage is raw, uninitialized memory: only the first `size()` slots hold
+ * constructed elements, created in place with placement-new. Growing the
+ * vector moves the elements into the new block, and trivially copyable
+ * elements are relocated with a single memcpy.
+ *
  * @tparam T The type of elements stored in the vector.
+ * @tparam kAlignment Alignment of the storage in bytes (a power of two), for
+ * containers laid out along cache lines; 0 uses the default alignment.
  */
-template <typename T> class Vector {
+template <typename T, size_t kAlignment = 0> class Vector {
 private:
   T *data_; // Pointer to the dynamically allocated array.
   size_t
       capacity_; // Total number of elements that can be held without resizing.
   size_t count_; // Number of elements currently in the vector.
 
+  // Whether elements may be copied and relocated as raw bytes.
+  typedef std::integral_constant<bool, std::is_trivially_copyable<T>::value>
+      IsTrivial;
+
+  /**
+   * @brief Allocates uninitialized storage for a number of elements.
+   * @param capacity The number of elements.
+   * @return The storage, or nullptr if `capacity` is zero.
+   */
+  static T *Allocate(size_t capacity) {
+    if (capacity == 0)
+      return nullptr;
+    if (kAlignment > alignof(std::max_align_t)) {
+      void *memory = nullptr;
+      if (posix_memalign(&memory, kAlignment, capacity * sizeof(T)) != 0)
+        throw std::bad_alloc();
+      return static_cast<T *>(memory);
+    }
+    return static_cast<T *>(::operator new(capacity * sizeof(T)));
+  }
+
+  /**
+   * @brief Frees storage obtained from Allocate.
+   * @param data The storage, or nullptr.
+   */
+  static void Deallocate(T *data) {
+    if (kAlignment > alignof(std::max_align_t)) {
+      std::free(data);
+    } else {
+      ::operator delete(data);
+    }
+  }
+
+  /**
+   * @brief Destroys the elements in [first, last).
+   */
+  static void Destroy(T *first, T *last) {
+    if (!std::is_trivially_destructible<T>::value) {
+      for (; first != last; ++first) {
+        first->~T();
+      }
+    }
+  }
+
+  /**
+   * @brief Moves `count` elements into uninitialized storage as raw bytes.
+   */
+  static void Relocate(T *dest, T *source, size_t count, std::true_type) {
+    if (count > 0) {
+      std::memcpy(static_cast<void *>(dest), source, count * sizeof(T));
+    }
+  }
+
+  /**
+   * @brief Move-constructs `count` elements into uninitialized storage and
+   * destroys the originals.
+   */
+  static void Relocate(T *dest, T *source, size_t count, std::false_type) {
+    for (size_t i = 0; i < count; ++i) {
+      ::new (static_cast<void *>(dest + i)) T(std::move(source[i]));
+      source[i].~T();
+    }
+  }
+
+  /**
+   * @brief Copy-constructs `count` elements into uninitialized storage.
+   */
+  static void CopyInto(T *dest, const T *source, size_t count,
+                       std::true_type) {
+    if (count > 0) {
+      std::memcpy(static_cast<void *>(dest), source, count * sizeof(T));
+    }
+  }
+
+  /**
+   * @brief Copy-constructs `count` elements into uninitialized storage.
+   */
+  static void CopyInto(T *dest, const T *source, size_t count,
+                       std::false_type) {
+    for (size_t i = 0; i < count; ++i) {
+      ::new (static_cast<void *>(dest + i)) T(source[i]);
+    }
+  }
+
   /**
    * @brief Resizes the internal storage to a new capacity.
    *
-   * Allocates a new array of the specified capacity, copies existing elements
-   * to the new array, and deallocates the old array.
+   * Allocates uninitialized storage of the specified capacity, relocates the
+   * existing elements into it, and deallocates the old storage.
    *
-   * @param new_capacity The new capacity for the vector.
+   * @param new_capacity The new capacity for the vector (at least size()).
    */
   void resize(size_t new_capacity) {
-    T *new_data = new T[new_capacity];
-    for (size_t i = 0; i < count_; ++i) {
-      new_data[i] = data_[i];
-    }
-    delete[] data_;
+    T *new_data = Allocate(new_capacity);
+    Relocate(new_data, data_, count_, IsTrivial());
+    Deallocate(data_);
     data_ = new_data;
     capacity_ = new_capacity;
   }
 
+  /**
+   * @brief Returns the capacity to grow to when the vector is full.
+   *
+   * Doubles the capacity (or sets it to 4 if empty) to ensure amortized
+   * constant time complexity O(1) for appends.
+   */
+  size_t GrowthCapacity() const { return capacity_ == 0 ? 4 : capacity_ * 2; }
+
 public:
   /**
    * @brief Default constructor.
@@ -50,9 +154,12 @@ public:
   /**
    * @brief Destructor.
    *
-   * Deallocates the memory used by the vector.
+   * Destroys the elements and deallocates the memory used by the vector.
    */
-  ~Vector() { delete[] data_; }
+  ~Vector() {
+    Destroy(data_, data_ + count_);
+    Deallocate(data_);
+  }
 
   /**
    * @brief Copy constructor.
@@ -63,37 +170,72 @@ public:
    */
   Vector(const Vector &other) : data_(nullptr), capacity_(0), count_(0) {
     if (other.count_ > 0) {
-      resize(other.capacity_);
-      for (size_t i = 0; i < other.count_; ++i) {
-        data_[i] = other.data_[i];
-      }
+      data_ = Allocate(other.count_);
+      capacity_ = other.count_;
+      CopyInto(data_, other.data_, other.count_, IsTrivial());
       count_ = other.count_;
     }
   }
 
+  /**
+   * @brief Move constructor.
+   *
+   * Takes over the storage of another vector, which is left empty.
+   *
+   * @param other The vector to move from.
+   */
+  Vector(Vector &&other) noexcept
+      : data_(other.data_), capacity_(other.capacity_), count_(other.count_) {
+    other.data_ = nullptr;
+    other.capacity_ = 0;
+    other.count_ = 0;
+  }
+
   /**
    * @brief Copy assignment operator.
    *
    * Replaces the contents with a copy of the contents of another vector.
-   * Handles self-assignment and ensures strong exception safety guarantees
-   * where possible.
+   * Handles self-assignment; the current storage is reused when it is large
+   * enough.
    *
    * @param other The vector to copy from.
    * @return Reference to this vector.
    */
   Vector &operator=(const Vector &other) {
     if (this != &other) {
-      delete[] data_;
-      data_ = nullptr;
-      capacity_ = 0;
-      count_ = 0;
-      if (other.count_ > 0) {
-        resize(other.capacity_);
-        for (size_t i = 0; i < other.count_; ++i) {
-          data_[i] = other.data_[i];
-        }
-        count_ = other.count_;
+      clear();
+      if (other.count_ > capacity_) {
+        Deallocate(data_);
+        data_ = nullptr;
+        capacity_ = 0;
+        data_ = Allocate(other.count_);
+        capacity_ = other.count_;
       }
+      CopyInto(data_, other.data_, other.count_, IsTrivial());
+      count_ = other.count_;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment operator.
+   *
+   * Releases the current contents and takes over the storage of another
+   * vector, which is left empty.
+   *
+   * @param other The vector to move from.
+   * @return Reference to this vector.
+   */
+  Vector &operator=(Vector &&other) noexcept {
+    if (this != &other) {
+      Destroy(data_, data_ + count_);
+      Deallocate(data_);
+      data_ = other.data_;
+      capacity_ = other.capacity_;
+      count_ = other.count_;
+      other.data_ = nullptr;
+      other.capacity_ = 0;
+      other.count_ = 0;
     }
     return *this;
   }
@@ -107,11 +249,38 @@ public:
    *
    * @param value The value to be added.
    */
-  void push_back(const T &value) {
-    if (count_ == capacity_) {
-      resize(capacity_ == 0 ? 4 : capacity_ * 2);
+  void push_back(const T &value) { emplace_back(value); }
+
+  /**
+   * @brief Adds an element to the end of the vector, moving from it.
+   *
+   * @param value The value to be added.
+   */
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  /**
+   * @brief Constructs an element in place at the end of the vector.
+   *
+   * The arguments may refer to an element of this vector: on growth the new
+   * element is constructed before the old storage is released.
+   *
+   * @param args The arguments forwarded to the element's constructor.
+   */
+  template <typename... Args> void emplace_back(Args &&...args) {
+    if (count_ < capacity_) {
+      ::new (static_cast<void *>(data_ + count_))
+          T(std::forward<Args>(args)...);
+    } else {
+      size_t new_capacity = GrowthCapacity();
+      T *new_data = Allocate(new_capacity);
+      ::new (static_cast<void *>(new_data + count_))
+          T(std::forward<Args>(args)...);
+      Relocate(new_data, data_, count_, IsTrivial());
+      Deallocate(data_);
+      data_ = new_data;
+      capacity_ = new_capacity;
     }
-    data_[count_++] = value;
+    count_++;
   }
 
   /**
@@ -123,6 +292,29 @@ public:
   void pop_back() {
     if (count_ > 0) {
       count_--;
+      Destroy(data_ + count_, data_ + count_ + 1);
+    }
+  }
+
+  /**
+   * @brief Ensures room for at least `new_capacity` elements.
+   *
+   * Does nothing if the capacity is already large enough.
+   *
+   * @param new_capacity The minimum capacity.
+   */
+  void reserve(size_t new_capacity) {
+    if (new_capacity > capacity_) {
+      resize(new_capacity);
+    }
+  }
+
+  /**
+   * @brief Releases unused capacity, shrinking the storage to size().
+   */
+  void shrink_to_fit() {
+    if (capacity_ > count_) {
+      resize(count_);
     }
   }
 
@@ -160,6 +352,33 @@ public:
     return data_[index];
   }
 
+  /**
+   * @brief Accesses the element at the specified index without bounds
+   * checking.
+   *
+   * For hot paths whose indices are valid by construction. The index is only
+   * verified in builds with DEBUG_CHECK enabled. Time complexity: O(1).
+   *
+   * @param index The index of the element to access (must be < size()).
+   * @return Reference to the element at the specified index.
+   */
+  T &unchecked_at(size_t index) {
+    DEBUG_CHECK(index < count_);
+    return data_[index];
+  }
+
+  /**
+   * @brief Accesses the element at the specified index without bounds
+   * checking (const version).
+   *
+   * @param index The index of the element to access (must be < size()).
+   * @return Const reference to the element at the specified index.
+   */
+  const T &unchecked_at(size_t index) const {
+    DEBUG_CHECK(index < count_);
+    return data_[index];
+  }
+
   /**
    * @brief Returns the number of elements in the vector.
    *
@@ -167,6 +386,13 @@ public:
    */
   size_t size() const { return count_; }
 
+  /**
+   * @brief Returns the number of elements the storage can hold.
+   *
+   * @return The capacity.
+   */
+  size_t capacity() const { return capacity_; }
+
   /**
    * @brief Checks if the vector is empty.
    *
@@ -177,10 +403,12 @@ public:
   /**
    * @brief Clears the contents of the vector.
    *
-   * Logical clear; does not deallocate internal memory, merely resets the
-   * count.
+   * Destroys every element but does not deallocate internal memory.
    */
-  void clear() { count_ = 0; }
+  void clear() {
+    Destroy(data_, data_ + count_);
+    count_ = 0;
+  }
 
   /**
    * @brief Returns a pointer to the first element.
@@ -0,0 +1,56 @@
+#include "arena.h"
+
+Arena::Arena(size_t block_size)
+    : blocks_(nullptr), cursor_(nullptr), limit_(nullptr),
+      block_size_(block_size), bytes_used_(0), finalizers_(nullptr) {}
+
+Arena::~Arena() { Release(); }
+
+void Arena::Grow(size_t min_size) {
+  size_t size = (min_size > block_size_) ? min_size : block_size_;
+  char *memory = new char[sizeof(Block) + size];
+  Block *block = reinterpret_cast<Block *>(memory);
+  block->next = blocks_;
+  block->size = size;
+  blocks_ = block;
+  cursor_ = memory + sizeof(Block);
+  limit_ = cursor_ + size;
+}
+
+void *Arena::Allocate(size_t size, size_t alignment) {
+  size_t mask = alignment - 1;
+  size_t address = reinterpret_cast<size_t>(cursor_);
+  size_t padding = (alignment - (address & mask)) & mask;
+
+  if (cursor_ == nullptr || padding + size > (size_t)(limit_ - cursor_)) {
+    // Reserve room for the worst-case padding of a fresh block.
+    Grow(size + mask);
+    address = reinterpret_cast<size_t>(cursor_);
+    padding = (alignment - (address & mask)) & mask;
+  }
+
+  char *result = cursor_ + padding;
+  cursor_ = result + size;
+  bytes_used_ += padding + size;
+  return result;
+}
+
+void Arena::Release() {
+  while (finalizers_ != nullptr) {
+    Finalizer *finalizer = finalizers_;
+    finalizers_ = finalizer->next;
+    finalizer->destroy(finalizer->object);
+  }
+
+  while (blocks_ != nullptr) {
+    Block *block = blocks_;
+    blocks_ = block->next;
+    delete[] reinterpret_cast<char *>(block);
+  }
+
+  cursor_ = nullptr;
+  limit_ = nullptr;
+  bytes_used_ = 0;
+}
+
+size_t Arena::GetBytesUsed() const { return bytes_used_; }
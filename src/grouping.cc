@@ -0,0 +1,563 @@
+#include "grouping.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+
+#include "arena.h"
+#include "proximity_kernel.h"
+#include "request.h"
+#include "request_table.h"
+#include "ride.h"
+#include "spatial_grid.h"
+
+namespace {
+
+const size_t kShardsPerThread = 4; // Shards planned per worker thread.
+
+/**
+ * @brief Creates rides with inline slots for a capacity known at compile
+ * time.
+ */
+template <int kMaxRequests> struct FixedRideLayout {
+  int GetMaxRequests() const { return kMaxRequests; }
+  Ride *NewRide(Arena &arena) const {
+    return arena.New<FixedRide<kMaxRequests> >(&arena);
+  }
+};
+
+/**
+ * @brief Creates rides with growing slots, for larger capacities.
+ */
+struct GenericRideLayout {
+  int max_requests; // Maximum number of requests of a ride.
+
+  int GetMaxRequests() const { return max_requests; }
+  Ride *NewRide(Arena &arena) const { return arena.New<Ride>(&arena); }
+};
+
+/**
+ * @brief Gets the limit on squared distances for Constraint 2.
+ *
+ * A negative maximum distance admits no pair, so it maps to a negative limit,
+ * which every squared distance exceeds.
+ */
+double GetMaxDistanceSq(const SimulationParams &params) {
+  if (params.max_distance < 0)
+    return -1.0;
+  return params.max_distance * params.max_distance;
+}
+
+/**
+ * @brief Gets the number of requests a ride can hold.
+ *
+ * The first request always forms a ride, whatever the capacity.
+ */
+int GetMaxRequests(const SimulationParams &params) {
+  return (params.capacity > 1) ? params.capacity : 1;
+}
+
+/**
+ * @brief The constraints of the grouping heuristics.
+ */
+enum class Constraint {
+  kNone,       // Every constraint is met.
+  kCapacity,   // Constraint 1: Vehicle Capacity.
+  kDistance,   // Constraint 2: Distance Proximity.
+  kEfficiency, // Constraint 3: Efficiency.
+  kDelay       // Constraint 4: Max Delay.
+};
+
+/**
+ * @brief Adds a rejection to the count of its constraint.
+ * @param failed The constraint that rejected a request.
+ * @param stats The counts, or nullptr.
+ */
+void CountRejection(Constraint failed, GroupingStats *stats) {
+  if (stats == nullptr)
+    return;
+  switch (failed) {
+  case Constraint::kCapacity:
+    ++stats->capacity_rejections;
+    break;
+  case Constraint::kDistance:
+    ++stats->distance_rejections;
+    break;
+  case Constraint::kEfficiency:
+    ++stats->efficiency_rejections;
+    break;
+  case Constraint::kDelay:
+    ++stats->delay_rejections;
+    break;
+  case Constraint::kNone:
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief Checks whether the greedy heuristic can append a row to a ride.
+ *
+ * @param r The ride, which holds the consecutive rows [first, row).
+ * @param max_requests The maximum number of requests of a ride.
+ * @param table The requests.
+ * @param first The first row of the ride.
+ * @param row The candidate row.
+ * @param request The request of the candidate row.
+ * @param params The simulation parameters.
+ * @param max_distance_sq The limit of Constraint 2 (see GetMaxDistanceSq).
+ * @param[out] insertion The evaluation of the insertion, once Constraint 3 is
+ * reached.
+ * @return The first constraint the row fails, or Constraint::kNone.
+ */
+inline Constraint CheckGreedyConstraints(const Ride &r, int max_requests,
+                                         const RequestTable &table,
+                                         size_t first, size_t row,
+                                         const Request *request,
+                                         const SimulationParams &params,
+                                         double max_distance_sq,
+                                         InsertionResult &insertion) {
+  // Constraint 1: Vehicle Capacity
+  if (r.GetDemandCount() >= max_requests)
+    return Constraint::kCapacity;
+
+  // Constraint 2: Distance Proximity
+  // Checks every rider of the ride at once with the vectorized kernel.
+  if (!AllWithinDistance(table.GetOriginXData() + first,
+                         table.GetOriginYData() + first,
+                         table.GetDestXData() + first,
+                         table.GetDestYData() + first, row - first,
+                         table.GetOrigin(row), table.GetDestination(row),
+                         max_distance_sq))
+    return Constraint::kDistance;
+
+  // Constraint 3: Efficiency
+  // Evaluated incrementally from the ride's running route sums.
+  insertion = r.EvaluateInsertion(request);
+  if (insertion.efficiency < params.min_efficiency)
+    return Constraint::kEfficiency;
+
+  // Constraint 4: Max Delay
+  if (std::abs(table.GetTime(row) - table.GetTime(first)) > params.max_delay)
+    return Constraint::kDelay;
+
+  return Constraint::kNone;
+}
+
+/**
+ * @brief Runs GroupGreedy over the rows in [begin, end).
+ * @tparam Layout FixedRideLayout or GenericRideLayout.
+ */
+template <typename Layout>
+void GreedyRows(const Layout &layout, const RequestTable &table,
+                Vector<Request> &requests, size_t begin, size_t end,
+                const SimulationParams &params, Arena &arena,
+                Vector<Ride *> &rides, Vector<size_t> *deferred,
+                GroupingStats *stats) {
+  double max_distance_sq = GetMaxDistanceSq(params);
+
+  // A ride always holds a run of consecutive rows [first, i), so the
+  // constraint checks stream through the table's columns.
+  size_t i = begin;
+  while (i < end) {
+    // Start a new ride with the current request
+    size_t first = i;
+    Ride *r = layout.NewRide(arena);
+    r->AddRequest(&requests.unchecked_at(i));
+    i++;
+
+    // Try to add subsequent requests to this ride
+    while (i < end) {
+      Request *request = &requests.unchecked_at(i);
+      InsertionResult insertion;
+      Constraint failed =
+          CheckGreedyConstraints(*r, layout.GetMaxRequests(), table, first, i,
+                                 request, params, max_distance_sq, insertion);
+      if (failed != Constraint::kNone) {
+        CountRejection(failed, stats);
+        break;
+      }
+
+      // All constraints passed, add request to the ride
+      r->CommitInsertion(request, insertion);
+      i++;
+    }
+
+    // Every request was accepted: later ones might be too, so the ride is
+    // left to the caller, to be formed again once they are known.
+    if (i == end && deferred != nullptr) {
+      for (size_t row = first; row < i; ++row) {
+        deferred->push_back(row);
+      }
+      return;
+    }
+
+    // Build the segments once the ride is closed
+    r->UpdateRoute(params.speed);
+    rides.push_back(r);
+  }
+}
+
+/**
+ * @brief Runs GroupWithGrid over the rows in [begin, end).
+ *
+ * Rows are numbered from `begin` (local row 0) inside the grid and the
+ * assignment flags.
+ *
+ * @tparam Layout FixedRideLayout or GenericRideLayout.
+ */
+template <typename Layout>
+void GridRows(const Layout &layout, const RequestTable &table,
+              Vector<Request> &requests, size_t begin, size_t end,
+              const SimulationParams &params, Arena &arena,
+              Vector<Ride *> &rides, Vector<size_t> *deferred,
+              GroupingStats *stats) {
+  double max_distance_sq = GetMaxDistanceSq(params);
+  size_t n = end - begin;
+
+  Vector<char> assigned;
+  assigned.reserve(n);
+  for (size_t row = 0; row < n; ++row) {
+    assigned.push_back(0);
+  }
+
+  SpatialGrid grid(params.max_distance);
+  Vector<size_t> candidates;
+  // Coordinates of the riders of the ride being built, for the kernel.
+  Vector<double> origin_x, origin_y, dest_x, dest_y;
+
+  size_t seed = 0;
+  size_t next_insert = 0;
+  for (;;) {
+    while (seed < n && assigned.unchecked_at(seed))
+      ++seed;
+    if (seed == n)
+      break;
+
+    // Slide the time window: index every request within max_delay of the
+    // seed. Rows before the seed are all assigned already.
+    size_t seed_row = begin + seed;
+    long seed_time = table.GetTime(seed_row);
+    if (next_insert <= seed)
+      next_insert = seed + 1;
+    while (next_insert < n && table.GetTime(begin + next_insert) - seed_time <=
+                                  params.max_delay) {
+      grid.Insert(next_insert, table.GetOrigin(begin + next_insert));
+      ++next_insert;
+    }
+
+    // The window may extend past the table: leave this seed and every
+    // unassigned request after it to the caller.
+    if (next_insert == n && deferred != nullptr) {
+      for (size_t local = seed; local < n; ++local) {
+        if (!assigned.unchecked_at(local))
+          deferred->push_back(begin + local);
+      }
+      return;
+    }
+
+    // Start a new ride with the seed
+    Ride *r = layout.NewRide(arena);
+    r->AddRequest(&requests.unchecked_at(seed_row));
+    assigned.unchecked_at(seed) = 1;
+    origin_x.clear();
+    origin_y.clear();
+    dest_x.clear();
+    dest_y.clear();
+    origin_x.push_back(table.GetOrigin(seed_row).x);
+    origin_y.push_back(table.GetOrigin(seed_row).y);
+    dest_x.push_back(table.GetDestination(seed_row).x);
+    dest_y.push_back(table.GetDestination(seed_row).y);
+
+    // Every compatible request is within max_distance of the seed's origin,
+    // hence in its 3x3 cell neighborhood.
+    if (r->GetDemandCount() < layout.GetMaxRequests()) {
+      grid.QueryNeighborhood(table.GetOrigin(seed_row), seed + 1, assigned,
+                             candidates);
+    } else {
+      candidates.clear();
+    }
+
+    for (size_t k = 0; k < candidates.size(); ++k) {
+      // Constraint 1: Vehicle Capacity
+      if (r->GetDemandCount() >= layout.GetMaxRequests()) {
+        if (stats != nullptr)
+          ++stats->capacity_rejections;
+        break;
+      }
+
+      size_t local = candidates.unchecked_at(k);
+      size_t row = begin + local;
+
+      // Constraint 4: Max Delay
+      if (std::abs(table.GetTime(row) - seed_time) > params.max_delay) {
+        if (stats != nullptr)
+          ++stats->delay_rejections;
+        continue;
+      }
+
+      // Constraint 2: Distance Proximity
+      if (!AllWithinDistance(origin_x.begin(), origin_y.begin(),
+                             dest_x.begin(), dest_y.begin(), origin_x.size(),
+                             table.GetOrigin(row), table.GetDestination(row),
+                             max_distance_sq)) {
+        if (stats != nullptr)
+          ++stats->distance_rejections;
+        continue;
+      }
+
+      // Constraint 3: Efficiency
+      Request *request = &requests.unchecked_at(row);
+      InsertionResult insertion = r->EvaluateInsertion(request);
+      if (insertion.efficiency < params.min_efficiency) {
+        if (stats != nullptr)
+          ++stats->efficiency_rejections;
+        continue;
+      }
+
+      r->CommitInsertion(request, insertion);
+      assigned.unchecked_at(local) = 1;
+      origin_x.push_back(table.GetOrigin(row).x);
+      origin_y.push_back(table.GetOrigin(row).y);
+      dest_x.push_back(table.GetDestination(row).x);
+      dest_y.push_back(table.GetDestination(row).y);
+    }
+
+    r->UpdateRoute(params.speed);
+    rides.push_back(r);
+  }
+}
+
+/**
+ * @brief A run of rows grouped independently of the others.
+ */
+struct Shard {
+  size_t begin;         // First row of the shard.
+  size_t end;           // One past the last row of the shard.
+  Arena *arena;         // Allocates the rides of the shard.
+  Vector<Ride *> rides; // Rides formed from the shard, in order.
+  GroupingStats stats;  // Rejections within the shard.
+};
+
+/**
+ * @brief Groups the rows of a given range with the selected strategy and
+ * ride layout.
+ */
+template <typename Layout>
+void GroupRowsWith(const Layout &layout, GroupingMode mode,
+                   const RequestTable &table, Vector<Request> &requests,
+                   size_t begin, size_t end, const SimulationParams &params,
+                   Arena &arena, Vector<Ride *> &rides,
+                   Vector<size_t> *deferred, GroupingStats *stats) {
+  if (mode == GroupingMode::kGrid) {
+    GridRows(layout, table, requests, begin, end, params, arena, rides,
+             deferred, stats);
+  } else {
+    GreedyRows(layout, table, requests, begin, end, params, arena, rides,
+               deferred, stats);
+  }
+}
+
+/**
+ * @brief Groups the rows of a given range with the selected strategy.
+ *
+ * Capacities up to 6, the common ones, use rides with inline slots and the
+ * capacity as a compile-time constant; larger ones use generic rides, whose
+ * slots grow with the requests actually added.
+ */
+void GroupRows(GroupingMode mode, const RequestTable &table,
+               Vector<Request> &requests, size_t begin, size_t end,
+               const SimulationParams &params, Arena &arena,
+               Vector<Ride *> &rides, Vector<size_t> *deferred,
+               GroupingStats *stats) {
+  switch (GetMaxRequests(params)) {
+  case 1:
+    GroupRowsWith(FixedRideLayout<1>(), mode, table, requests, begin, end,
+                  params, arena, rides, deferred, stats);
+    break;
+  case 2:
+    GroupRowsWith(FixedRideLayout<2>(), mode, table, requests, begin, end,
+                  params, arena, rides, deferred, stats);
+    break;
+  case 3:
+    GroupRowsWith(FixedRideLayout<3>(), mode, table, requests, begin, end,
+                  params, arena, rides, deferred, stats);
+    break;
+  case 4:
+    GroupRowsWith(FixedRideLayout<4>(), mode, table, requests, begin, end,
+                  params, arena, rides, deferred, stats);
+    break;
+  case 5:
+    GroupRowsWith(FixedRideLayout<5>(), mode, table, requests, begin, end,
+                  params, arena, rides, deferred, stats);
+    break;
+  case 6:
+    GroupRowsWith(FixedRideLayout<6>(), mode, table, requests, begin, end,
+                  params, arena, rides, deferred, stats);
+    break;
+  default: {
+    GenericRideLayout layout = {GetMaxRequests(params)};
+    GroupRowsWith(layout, mode, table, requests, begin, end, params, arena,
+                  rides, deferred, stats);
+    break;
+  }
+  }
+}
+
+/**
+ * @brief Splits the rows into shards that no ride can span.
+ *
+ * A row that comes more than `max_delay` after every row before it fails
+ * Constraint 4 against any earlier first rider, and lies outside the time
+ * window of any earlier seed, so it always starts a new ride. The table is
+ * cut at such rows into shards of about `target_rows` rows or more.
+ *
+ * @param table The requests, in input order.
+ * @param max_delay The maximum delay of the simulation.
+ * @param target_rows The preferred number of rows per shard.
+ * @param[out] ends Receives one past the last row of each shard.
+ */
+void FindShardEnds(const RequestTable &table, double max_delay,
+                   size_t target_rows, Vector<size_t> &ends) {
+  size_t n = table.size();
+  size_t begin = 0;
+  long latest = (n > 0) ? table.GetTime(0) : 0;
+  for (size_t row = 1; row < n; ++row) {
+    long time = table.GetTime(row);
+    if (row - begin >= target_rows && time - latest > max_delay) {
+      ends.push_back(row);
+      begin = row;
+    }
+    if (time > latest)
+      latest = time;
+  }
+  ends.push_back(n);
+}
+
+} // namespace
+
+void GroupingStats::Add(const GroupingStats &other) {
+  capacity_rejections += other.capacity_rejections;
+  distance_rejections += other.distance_rejections;
+  efficiency_rejections += other.efficiency_rejections;
+  delay_rejections += other.delay_rejections;
+}
+
+void GroupGreedy(const RequestTable &table, Vector<Request> &requests,
+                 const SimulationParams &params, Arena &arena,
+                 Vector<Ride *> &rides, Vector<size_t> *deferred,
+                 GroupingStats *stats) {
+  GroupRows(GroupingMode::kGreedy, table, requests, 0, table.size(), params,
+            arena, rides, deferred, stats);
+}
+
+void GroupWithGrid(const RequestTable &table, Vector<Request> &requests,
+                   const SimulationParams &params, Arena &arena,
+                   Vector<Ride *> &rides, Vector<size_t> *deferred,
+                   GroupingStats *stats) {
+  GroupRows(GroupingMode::kGrid, table, requests, 0, table.size(), params,
+            arena, rides, deferred, stats);
+}
+
+void GroupRequests(GroupingMode mode, const RequestTable &table,
+                   Vector<Request> &requests, const SimulationParams &params,
+                   Arena &arena, Vector<Ride *> &rides,
+                   Vector<size_t> *deferred, GroupingStats *stats) {
+  switch (mode) {
+  case GroupingMode::kGrid:
+    GroupWithGrid(table, requests, params, arena, rides, deferred, stats);
+    break;
+  case GroupingMode::kGreedy:
+  default:
+    GroupGreedy(table, requests, params, arena, rides, deferred, stats);
+    break;
+  }
+}
+
+void GroupRequestsParallel(GroupingMode mode, const RequestTable &table,
+                           Vector<Request> &requests,
+                           const SimulationParams &params, int thread_count,
+                           Arena &arena, Vector<Ride *> &rides,
+                           GroupingStats *stats) {
+  size_t n = table.size();
+  if (thread_count < 2 || n == 0) {
+    GroupRequests(mode, table, requests, params, arena, rides, nullptr, stats);
+    return;
+  }
+
+  // A few shards per thread, so that uneven shards still balance out.
+  Vector<size_t> ends;
+  size_t target_rows = n / ((size_t)thread_count * kShardsPerThread) + 1;
+  FindShardEnds(table, params.max_delay, target_rows, ends);
+  if (ends.size() < 2) {
+    GroupRequests(mode, table, requests, params, arena, rides, nullptr, stats);
+    return;
+  }
+
+  // Each shard allocates from its own arena, which lives in the caller's.
+  Vector<Shard> shards;
+  shards.reserve(ends.size());
+  size_t begin = 0;
+  for (size_t k = 0; k < ends.size(); ++k) {
+    Shard shard;
+    shard.begin = begin;
+    shard.end = ends[k];
+    shard.arena = arena.New<Arena>();
+    shards.push_back(shard);
+    begin = ends[k];
+  }
+
+  // Workers take the next shard until none is left.
+  std::atomic<size_t> next_shard(0);
+  Vector<std::thread> workers;
+  int worker_count = thread_count;
+  if ((size_t)worker_count > shards.size())
+    worker_count = (int)shards.size();
+  for (int t = 0; t < worker_count; ++t) {
+    workers.emplace_back([&]() {
+      for (;;) {
+        size_t k = next_shard.fetch_add(1);
+        if (k >= shards.size())
+          break;
+        Shard &shard = shards.unchecked_at(k);
+        GroupRows(mode, table, requests, shard.begin, shard.end, params,
+                  *shard.arena, shard.rides, nullptr,
+                  (stats != nullptr) ? &shard.stats : nullptr);
+      }
+    });
+  }
+  for (size_t t = 0; t < workers.size(); ++t) {
+    workers[t].join();
+  }
+
+  // Shards hold consecutive rows, so concatenating their rides in order
+  // gives the order of a single pass.
+  for (size_t k = 0; k < shards.size(); ++k) {
+    const Vector<Ride *> &shard_rides = shards.unchecked_at(k).rides;
+    for (size_t i = 0; i < shard_rides.size(); ++i) {
+      rides.push_back(shard_rides.unchecked_at(i));
+    }
+    if (stats != nullptr)
+      stats->Add(shards.unchecked_at(k).stats);
+  }
+
+  // A single greedy pass also checks the first row of each shard against the
+  // last ride of the previous shard, which ends at the cut, before starting
+  // a new ride: count that rejection as it would. The grid never indexes a
+  // row past the cut while seeding from before it, so it counts none there.
+  if (stats != nullptr && mode == GroupingMode::kGreedy) {
+    double max_distance_sq = GetMaxDistanceSq(params);
+    for (size_t k = 1; k < shards.size(); ++k) {
+      const Vector<Ride *> &previous = shards.unchecked_at(k - 1).rides;
+      const Ride *last = previous.unchecked_at(previous.size() - 1);
+      size_t row = shards.unchecked_at(k).begin;
+      InsertionResult insertion;
+      CountRejection(CheckGreedyConstraints(
+                         *last, GetMaxRequests(params), table,
+                         row - last->GetDemandCount(), row,
+                         &requests.unchecked_at(row), params,
+                         max_distance_sq, insertion),
+                     stats);
+    }
+  }
+}
@@ -0,0 +1,312 @@
+#include "input_reader.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "point.h"
+#include "request_table.h"
+
+namespace {
+
+// Size of the first read buffer when the input cannot be memory-mapped.
+const size_t kBlockSize = 1 << 20;
+
+// Most rows preallocated from the declared request count, so a bogus count
+// cannot exhaust memory before any line is read.
+const size_t kMaxReservedRows = 1 << 22;
+
+// Powers of ten that are exactly representable as doubles.
+const double kPow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                         1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                         1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool IsSpace(char c) {
+  return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+/**
+ * @brief Parses a decimal floating-point token.
+ *
+ * The digits are accumulated into a 64-bit mantissa. If the mantissa and the
+ * decimal exponent are both exactly representable, one multiplication or
+ * division yields the correctly rounded result (Clinger's fast path).
+ * Otherwise the token is handed to strtod, which must consume all of it.
+ */
+bool ParseDouble(const char *start, size_t length, double &value) {
+  const char *p = start;
+  const char *end = start + length;
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  int significant = 0;
+  int exponent = 0;
+  bool any_digit = false;
+  bool exact = true;
+
+  for (; p < end && IsDigit(*p); ++p) {
+    any_digit = true;
+    if (mantissa != 0 || *p != '0') {
+      if (++significant > 19)
+        exact = false;
+    }
+    mantissa = mantissa * 10 + (*p - '0');
+  }
+  if (p < end && *p == '.') {
+    for (++p; p < end && IsDigit(*p); ++p) {
+      any_digit = true;
+      if (mantissa != 0 || *p != '0') {
+        if (++significant > 19)
+          exact = false;
+      }
+      mantissa = mantissa * 10 + (*p - '0');
+      --exponent;
+    }
+  }
+  if (any_digit && p < end && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool exp_negative = false;
+    if (p < end && (*p == '+' || *p == '-')) {
+      exp_negative = (*p == '-');
+      ++p;
+    }
+    int exp_value = 0;
+    if (p == end || !IsDigit(*p))
+      exact = false;
+    for (; p < end && IsDigit(*p); ++p) {
+      if (exp_value < 10000)
+        exp_value = exp_value * 10 + (*p - '0');
+    }
+    exponent += exp_negative ? -exp_value : exp_value;
+  }
+
+  if (any_digit && exact && p == end && mantissa <= (1ULL << 53) &&
+      exponent >= -22 && exponent <= 22) {
+    double result = (double)mantissa;
+    result = (exponent < 0) ? result / kPow10[-exponent]
+                            : result * kPow10[exponent];
+    value = negative ? -result : result;
+    return true;
+  }
+
+  std::string token(start, length);
+  char *parsed_end = nullptr;
+  value = std::strtod(token.c_str(), &parsed_end);
+  return parsed_end == token.c_str() + length;
+}
+
+/**
+ * @brief Parses a decimal integer token.
+ *
+ * Tokens with up to 18 digits are converted directly; longer ones go through
+ * strtol. A token with trailing non-digits or out of range for long is
+ * rejected.
+ */
+bool ParseLong(const char *start, size_t length, long &value) {
+  const char *p = start;
+  const char *end = start + length;
+  bool negative = false;
+  if (p < end && (*p == '+' || *p == '-')) {
+    negative = (*p == '-');
+    ++p;
+  }
+  if (p == end || !IsDigit(*p))
+    return false;
+
+  if (end - p > 18) {
+    std::string token(start, length);
+    char *parsed_end = nullptr;
+    errno = 0;
+    value = std::strtol(token.c_str(), &parsed_end, 10);
+    return errno != ERANGE && parsed_end == token.c_str() + length;
+  }
+
+  long result = 0;
+  for (; p < end && IsDigit(*p); ++p) {
+    result = result * 10 + (*p - '0');
+  }
+  if (p != end)
+    return false;
+  value = negative ? -result : result;
+  return true;
+}
+
+} // namespace
+
+InputReader::InputReader()
+    : fd_(-1), data_(nullptr), capacity_(0), mapped_(0), cur_(nullptr),
+      end_(nullptr), mark_(nullptr), eof_(true), consumed_(0) {}
+
+InputReader::~InputReader() {
+  if (mapped_ > 0) {
+    munmap(data_, mapped_);
+  } else {
+    delete[] data_;
+  }
+}
+
+bool InputReader::Open(int fd) {
+  fd_ = fd;
+  consumed_ = 0;
+  mark_ = nullptr;
+
+  struct stat info;
+  if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode) && info.st_size > 0) {
+    void *mapping =
+        mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping != MAP_FAILED) {
+      madvise(mapping, info.st_size, MADV_SEQUENTIAL);
+      data_ = static_cast<char *>(mapping);
+      mapped_ = info.st_size;
+      cur_ = data_;
+      end_ = data_ + mapped_;
+      eof_ = true;
+      return true;
+    }
+  }
+
+  capacity_ = kBlockSize;
+  data_ = new char[capacity_];
+  cur_ = data_;
+  end_ = data_;
+  eof_ = false;
+  return true;
+}
+
+bool InputReader::Refill() {
+  if (eof_)
+    return false;
+
+  // Slide the characters that are still needed to the front of the buffer.
+  const char *keep = (mark_ != nullptr) ? mark_ : cur_;
+  size_t offset = keep - data_;
+  size_t remaining = end_ - keep;
+  std::memmove(data_, keep, remaining);
+  consumed_ += offset;
+  cur_ -= offset;
+  if (mark_ != nullptr)
+    mark_ -= offset;
+  end_ = data_ + remaining;
+
+  // A single token fills the buffer: grow it.
+  if (remaining == capacity_) {
+    char *bigger = new char[capacity_ * 2];
+    std::memcpy(bigger, data_, remaining);
+    cur_ = bigger + (cur_ - data_);
+    if (mark_ != nullptr)
+      mark_ = bigger + (mark_ - data_);
+    end_ = bigger + remaining;
+    delete[] data_;
+    data_ = bigger;
+    capacity_ *= 2;
+  }
+
+  for (;;) {
+    ssize_t count = read(fd_, data_ + remaining, capacity_ - remaining);
+    if (count > 0) {
+      end_ += count;
+      return true;
+    }
+    if (count < 0 && errno == EINTR)
+      continue;
+    eof_ = true;
+    return false;
+  }
+}
+
+bool InputReader::NextToken(const char *&start, size_t &length) {
+  for (;;) {
+    while (cur_ < end_ && IsSpace(*cur_))
+      ++cur_;
+    if (cur_ < end_)
+      break;
+    if (!Refill())
+      return false;
+  }
+
+  size_t scanned = 0;
+  for (;;) {
+    const char *p = cur_ + scanned;
+    while (p < end_ && !IsSpace(*p))
+      ++p;
+    scanned = p - cur_;
+    if (p < end_ || eof_)
+      break;
+    Refill();
+  }
+
+  start = cur_;
+  length = scanned;
+  cur_ += scanned;
+  return true;
+}
+
+bool InputReader::ReadInt(int &value) {
+  long wide;
+  if (!ReadLong(wide) || wide < INT_MIN || wide > INT_MAX)
+    return false;
+  value = (int)wide;
+  return true;
+}
+
+bool InputReader::ReadLong(long &value) {
+  const char *start;
+  size_t length;
+  return NextToken(start, length) && ParseLong(start, length, value);
+}
+
+bool InputReader::ReadDouble(double &value) {
+  const char *start;
+  size_t length;
+  return NextToken(start, length) && ParseDouble(start, length, value);
+}
+
+bool InputReader::ReadRequest(RequestTable &table) {
+  const char *id;
+  size_t id_length;
+  if (!NextToken(id, id_length))
+    return false;
+
+  // Keep the ID in the buffer while the numbers are read, so it can be copied
+  // straight into the table even if the buffer is refilled in between.
+  mark_ = id;
+  long time;
+  double ox, oy, dx, dy;
+  bool ok = ReadLong(time) && ReadDouble(ox) && ReadDouble(oy) &&
+            ReadDouble(dx) && ReadDouble(dy);
+  id = mark_;
+  mark_ = nullptr;
+  if (!ok)
+    return false;
+
+  table.Append(id, id_length, time, Point(ox, oy), Point(dx, dy));
+  return true;
+}
+
+size_t InputReader::ReadRequests(RequestTable &table, size_t count) {
+  table.reserve(table.size() +
+                (count < kMaxReservedRows ? count : kMaxReservedRows));
+  size_t read_count = 0;
+  while (read_count < count && ReadRequest(table)) {
+    ++read_count;
+  }
+  return read_count;
+}
+
+size_t InputReader::GetBytesConsumed() const {
+  return consumed_ + (cur_ - data_);
+}
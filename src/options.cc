@@ -0,0 +1,92 @@
+#include "options.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Checks whether an argument starts with a given option name.
+ * @param arg The argument to check.
+ * @param name The option name, including the trailing '='.
+ * @param[out] value Set to the text after the name on a match.
+ * @return true if arg starts with name.
+ */
+bool MatchOption(const char *arg, const char *name, const char *&value) {
+  size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) != 0)
+    return false;
+  value = arg + length;
+  return true;
+}
+
+void PrintUsage(const char *program) {
+  std::fprintf(stderr,
+               "usage: %s [--grouping=greedy|grid]"
+               " [--queue=heap2|heap4|heap8|calendar]"
+               " [--simulation=segments|fast] [--streaming] [--threads=N]"
+               " [--stats] < input_file\n",
+               program);
+}
+
+} // namespace
+
+bool ParseOptions(int argc, char **argv, SimulationOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const char *value;
+    if (MatchOption(argv[i], "--grouping=", value)) {
+      if (std::strcmp(value, "greedy") == 0) {
+        options.grouping = GroupingMode::kGreedy;
+      } else if (std::strcmp(value, "grid") == 0) {
+        options.grouping = GroupingMode::kGrid;
+      } else {
+        std::fprintf(stderr, "unknown grouping mode: %s\n", value);
+        PrintUsage(argv[0]);
+        return false;
+      }
+    } else if (MatchOption(argv[i], "--queue=", value)) {
+      if (std::strcmp(value, "heap2") == 0) {
+        options.event_queue = EventQueueKind::kBinaryHeap;
+      } else if (std::strcmp(value, "heap4") == 0) {
+        options.event_queue = EventQueueKind::kQuaternaryHeap;
+      } else if (std::strcmp(value, "heap8") == 0) {
+        options.event_queue = EventQueueKind::kOctonaryHeap;
+      } else if (std::strcmp(value, "calendar") == 0) {
+        options.event_queue = EventQueueKind::kCalendar;
+      } else {
+        std::fprintf(stderr, "unknown event queue: %s\n", value);
+        PrintUsage(argv[0]);
+        return false;
+      }
+    } else if (MatchOption(argv[i], "--simulation=", value)) {
+      if (std::strcmp(value, "segments") == 0) {
+        options.simulation = SimulationMode::kPerSegment;
+      } else if (std::strcmp(value, "fast") == 0) {
+        options.simulation = SimulationMode::kFast;
+      } else {
+        std::fprintf(stderr, "unknown simulation mode: %s\n", value);
+        PrintUsage(argv[0]);
+        return false;
+      }
+    } else if (std::strcmp(argv[i], "--streaming") == 0) {
+      options.streaming = true;
+    } else if (std::strcmp(argv[i], "--stats") == 0) {
+      options.stats = true;
+    } else if (MatchOption(argv[i], "--threads=", value)) {
+      char *end;
+      long threads = std::strtol(value, &end, 10);
+      if (end == value || *end != '\0' || threads < 1 || threads > 1024) {
+        std::fprintf(stderr, "invalid thread count: %s\n", value);
+        PrintUsage(argv[0]);
+        return false;
+      }
+      options.threads = (int)threads;
+    } else {
+      std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+      PrintUsage(argv[0]);
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,148 @@
+#include "output_writer.h"
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+// Powers of ten used to scale the fractional digits.
+const uint64_t kPow10[] = {1,      10,      100,      1000,      10000,
+                           100000, 1000000, 10000000, 100000000, 1000000000};
+
+// Largest precision handled without snprintf.
+const int kMaxFastPrecision = 9;
+
+// Largest number of bytes a single formatted number can take.
+const size_t kMaxNumberLength = 512;
+
+/**
+ * @brief Writes the decimal digits of an unsigned value, right to left.
+ * @param value The value to write.
+ * @param end One past the last position of the output.
+ * @return Pointer to the first written digit.
+ */
+char *FormatUnsigned(uint64_t value, char *end) {
+  do {
+    *--end = (char)('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  return end;
+}
+
+} // namespace
+
+OutputWriter::OutputWriter(int fd, size_t capacity)
+    : fd_(fd), buffer_(nullptr),
+      capacity_(capacity < kMaxNumberLength ? kMaxNumberLength : capacity),
+      used_(0) {
+  buffer_ = new char[capacity_];
+}
+
+OutputWriter::~OutputWriter() {
+  Flush();
+  delete[] buffer_;
+}
+
+void OutputWriter::Reserve(size_t size) {
+  if (capacity_ - used_ < size) {
+    Flush();
+  }
+}
+
+void OutputWriter::WriteChar(char c) {
+  Reserve(1);
+  buffer_[used_++] = c;
+}
+
+void OutputWriter::WriteString(const char *data, size_t length) {
+  if (length > capacity_) {
+    Flush();
+    while (length > 0) {
+      ssize_t count = write(fd_, data, length);
+      if (count < 0 && errno == EINTR)
+        continue;
+      if (count <= 0)
+        return;
+      data += count;
+      length -= count;
+    }
+    return;
+  }
+  Reserve(length);
+  std::memcpy(buffer_ + used_, data, length);
+  used_ += length;
+}
+
+void OutputWriter::WriteInt(long value) {
+  char digits[24];
+  char *end = digits + sizeof(digits);
+  uint64_t magnitude =
+      (value < 0) ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+  char *start = FormatUnsigned(magnitude, end);
+  if (value < 0)
+    *--start = '-';
+  WriteString(start, end - start);
+}
+
+void OutputWriter::WriteFixed(double value, int precision) {
+  Reserve(kMaxNumberLength);
+
+  // The scaled value must be small enough for its rounding error to be far
+  // below one half; anything else goes through snprintf.
+  bool fast = precision >= 0 && precision <= kMaxFastPrecision;
+  double scaled = fast ? std::fabs(value) * (double)kPow10[precision] : 0.0;
+  if (fast && std::isfinite(value) && scaled < 4503599627370496.0) { // 2^52
+    double whole = std::floor(scaled);
+    double fraction = scaled - whole;
+    // The product carries a relative error of at most 2^-53, so the rounding
+    // direction is only ambiguous when fraction is this close to one half.
+    double margin = scaled * 8.8817841970012523e-16 + 1e-300; // 2^-50
+    if (std::fabs(fraction - 0.5) > margin) {
+      uint64_t rounded = (uint64_t)whole + (fraction > 0.5 ? 1 : 0);
+
+      char digits[48];
+      char *end = digits + sizeof(digits);
+      char *start = end;
+      if (precision > 0) {
+        uint64_t frac_part = rounded % kPow10[precision];
+        for (int i = 0; i < precision; ++i) {
+          *--start = (char)('0' + frac_part % 10);
+          frac_part /= 10;
+        }
+        *--start = '.';
+      }
+      start = FormatUnsigned(rounded / kPow10[precision], start);
+      if (std::signbit(value))
+        *--start = '-';
+
+      std::memcpy(buffer_ + used_, start, end - start);
+      used_ += end - start;
+      return;
+    }
+  }
+
+  int length = std::snprintf(buffer_ + used_, kMaxNumberLength, "%.*f",
+                             precision, value);
+  if (length > 0) {
+    used_ += ((size_t)length < kMaxNumberLength) ? length
+                                                 : kMaxNumberLength - 1;
+  }
+}
+
+void OutputWriter::Flush() {
+  size_t written = 0;
+  while (written < used_) {
+    ssize_t count = write(fd_, buffer_ + written, used_ - written);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      break;
+    written += count;
+  }
+  used_ = 0;
+}
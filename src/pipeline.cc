@@ -0,0 +1,86 @@
+#include "pipeline.h"
+
+#include <cstddef>
+
+#include "arena.h"
+#include "grouping.h"
+#include "input_reader.h"
+#include "output_writer.h"
+#include "request.h"
+#include "request_table.h"
+#include "ride.h"
+#include "simulation.h"
+#include "simulation_params.h"
+#include "stats.h"
+#include "streaming.h"
+#include "vector.h"
+
+bool RunPipeline(const SimulationOptions &options, InputReader &reader,
+                 OutputWriter &output, RunStats *stats) {
+  Stopwatch stopwatch;
+  RunStats unused;
+  RunStats &measured = (stats != nullptr) ? *stats : unused;
+
+  SimulationParams params;
+  int num_requests = 0;
+
+  // Read simulation parameters
+  if (!(reader.ReadInt(params.capacity) && reader.ReadDouble(params.speed) &&
+        reader.ReadDouble(params.max_wait_time) &&
+        reader.ReadDouble(params.max_delay) &&
+        reader.ReadDouble(params.max_distance) &&
+        reader.ReadDouble(params.min_efficiency))) {
+    return false;
+  }
+
+  reader.ReadInt(num_requests);
+  size_t count = (num_requests > 0) ? num_requests : 0;
+
+  if (options.streaming) {
+    // All three phases, one batch of requests at a time
+    SimulateStream(options, params, reader, count, output, stats);
+    stopwatch.Lap();
+    output.Flush();
+    measured.output_seconds = stopwatch.Lap();
+    return true;
+  }
+
+  // Read requests straight into the columnar table
+  RequestTable table;
+  reader.ReadRequests(table, count);
+
+  // Lightweight views over the table rows, stored contiguously
+  Vector<Request> requests;
+  requests.reserve(table.size());
+  for (size_t row = 0; row < table.size(); ++row) {
+    requests.emplace_back(&table, row);
+  }
+  measured.requests = table.size();
+  measured.read_seconds = stopwatch.Lap();
+
+  Vector<Ride *> completed_rides;
+  Arena arena; // Owns every ride, stop and segment of the simulation.
+
+  // Phase 1: Grouping
+  // Combines requests into rides with the selected strategy, on independent
+  // time shards when several threads are requested.
+  GroupRequestsParallel(options.grouping, table, requests, params,
+                        options.threads, arena, completed_rides,
+                        (stats != nullptr) ? &stats->grouping : nullptr);
+  measured.group_seconds = stopwatch.Lap();
+
+  // Phases 2 and 3: Scheduling and Simulation
+  SimulateRides(options.simulation, options.event_queue, completed_rides,
+                output, (stats != nullptr) ? &stats->simulation : nullptr);
+
+  stopwatch.Lap();
+  output.Flush();
+  measured.output_seconds = stopwatch.Lap();
+
+  if (stats != nullptr)
+    stats->RecordRides(completed_rides);
+
+  // Cleanup
+  arena.Release();
+  return true;
+}
@@ -0,0 +1,142 @@
+#include "proximity_kernel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RIDE_DISPATCH_HAS_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+/**
+ * @brief Checks riders [begin, count) one at a time.
+ *
+ * Always inlined, so the SIMD kernels finish their tail in their own
+ * instruction set (calling legacy SSE code with dirty AVX state is costly).
+ */
+inline __attribute__((always_inline)) bool
+RemainingWithinDistance(const double *origin_x, const double *origin_y,
+                        const double *dest_x, const double *dest_y,
+                        size_t begin, size_t count, Point origin, Point dest,
+                        double max_distance_sq) {
+  for (size_t i = begin; i < count; ++i) {
+    double ox = origin_x[i] - origin.x;
+    double oy = origin_y[i] - origin.y;
+    double dx = dest_x[i] - dest.x;
+    double dy = dest_y[i] - dest.y;
+    if (ox * ox + oy * oy > max_distance_sq ||
+        dx * dx + dy * dy > max_distance_sq) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool AllWithinDistanceScalar(const double *origin_x, const double *origin_y,
+                             const double *dest_x, const double *dest_y,
+                             size_t count, Point origin, Point dest,
+                             double max_distance_sq) {
+  return RemainingWithinDistance(origin_x, origin_y, dest_x, dest_y, 0, count,
+                                 origin, dest, max_distance_sq);
+}
+
+#ifdef RIDE_DISPATCH_HAS_X86_KERNELS
+
+__attribute__((target("sse2"))) bool
+AllWithinDistanceSse2(const double *origin_x, const double *origin_y,
+                      const double *dest_x, const double *dest_y, size_t count,
+                      Point origin, Point dest, double max_distance_sq) {
+  const __m128d cox = _mm_set1_pd(origin.x);
+  const __m128d coy = _mm_set1_pd(origin.y);
+  const __m128d cdx = _mm_set1_pd(dest.x);
+  const __m128d cdy = _mm_set1_pd(dest.y);
+  const __m128d limit = _mm_set1_pd(max_distance_sq);
+
+  size_t i = 0;
+  for (; i + 2 <= count; i += 2) {
+    __m128d ox = _mm_sub_pd(_mm_loadu_pd(origin_x + i), cox);
+    __m128d oy = _mm_sub_pd(_mm_loadu_pd(origin_y + i), coy);
+    __m128d dx = _mm_sub_pd(_mm_loadu_pd(dest_x + i), cdx);
+    __m128d dy = _mm_sub_pd(_mm_loadu_pd(dest_y + i), cdy);
+    __m128d o2 = _mm_add_pd(_mm_mul_pd(ox, ox), _mm_mul_pd(oy, oy));
+    __m128d d2 = _mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy));
+    __m128d far = _mm_or_pd(_mm_cmpgt_pd(o2, limit), _mm_cmpgt_pd(d2, limit));
+    if (_mm_movemask_pd(far) != 0)
+      return false;
+  }
+  return RemainingWithinDistance(origin_x, origin_y, dest_x, dest_y, i, count,
+                                 origin, dest, max_distance_sq);
+}
+
+__attribute__((target("avx2"))) bool
+AllWithinDistanceAvx2(const double *origin_x, const double *origin_y,
+                      const double *dest_x, const double *dest_y, size_t count,
+                      Point origin, Point dest, double max_distance_sq) {
+  const __m256d cox = _mm256_set1_pd(origin.x);
+  const __m256d coy = _mm256_set1_pd(origin.y);
+  const __m256d cdx = _mm256_set1_pd(dest.x);
+  const __m256d cdy = _mm256_set1_pd(dest.y);
+  const __m256d limit = _mm256_set1_pd(max_distance_sq);
+
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d ox = _mm256_sub_pd(_mm256_loadu_pd(origin_x + i), cox);
+    __m256d oy = _mm256_sub_pd(_mm256_loadu_pd(origin_y + i), coy);
+    __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(dest_x + i), cdx);
+    __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(dest_y + i), cdy);
+    // Separate multiply and add (no FMA) keep the results identical to the
+    // scalar loop.
+    __m256d o2 = _mm256_add_pd(_mm256_mul_pd(ox, ox), _mm256_mul_pd(oy, oy));
+    __m256d d2 = _mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy));
+    __m256d far = _mm256_or_pd(_mm256_cmp_pd(o2, limit, _CMP_GT_OQ),
+                               _mm256_cmp_pd(d2, limit, _CMP_GT_OQ));
+    if (_mm256_movemask_pd(far) != 0)
+      return false;
+  }
+  return RemainingWithinDistance(origin_x, origin_y, dest_x, dest_y, i, count,
+                                 origin, dest, max_distance_sq);
+}
+
+#endif
+
+/**
+ * @brief Picks the kernel for the running CPU.
+ */
+ProximityKernel ResolveKernel() {
+  return GetProximityKernel(GetBestProximityIsa());
+}
+
+} // namespace
+
+bool AllWithinDistance(const double *origin_x, const double *origin_y,
+                       const double *dest_x, const double *dest_y,
+                       size_t count, Point origin, Point dest,
+                       double max_distance_sq) {
+  static const ProximityKernel kernel = ResolveKernel();
+  return kernel(origin_x, origin_y, dest_x, dest_y, count, origin, dest,
+                max_distance_sq);
+}
+
+ProximityKernel GetProximityKernel(ProximityIsa isa) {
+  switch (isa) {
+  case ProximityIsa::kScalar:
+    return &AllWithinDistanceScalar;
+#ifdef RIDE_DISPATCH_HAS_X86_KERNELS
+  case ProximityIsa::kSse2:
+    return __builtin_cpu_supports("sse2") ? &AllWithinDistanceSse2 : nullptr;
+  case ProximityIsa::kAvx2:
+    return __builtin_cpu_supports("avx2") ? &AllWithinDistanceAvx2 : nullptr;
+#endif
+  default:
+    return nullptr;
+  }
+}
+
+ProximityIsa GetBestProximityIsa() {
+#ifdef RIDE_DISPATCH_HAS_X86_KERNELS
+  if (__builtin_cpu_supports("avx2"))
+    return ProximityIsa::kAvx2;
+  if (__builtin_cpu_supports("sse2"))
+    return ProximityIsa::kSse2;
+#endif
+  return ProximityIsa::kScalar;
+}
@@ -1,35 +1,48 @@
 #include "request.h"
+#include "request_table.h"
 #include "ride.h"
 
 Request::Request()
-    : request_time_(0), state_(kRequested), associated_ride_(nullptr) {}
+    : table_(nullptr), row_(0), state_(kRequested), associated_ride_(nullptr) {}
 
-Request::Request(std::string id, long time, std::string origin,
-                 std::string dest)
-    : id_(id), request_time_(time), origin_(origin), destination_(dest),
-      state_(kRequested), associated_ride_(nullptr) {}
+Request::Request(RequestTable *table, size_t row)
+    : table_(table), row_(row), state_(kRequested), associated_ride_(nullptr) {}
 
 Request::~Request() {}
 
-std::string Request::GetId() const { return id_; }
+std::string Request::GetId() const { return table_->GetId(row_); }
 
-long Request::GetRequestTime() const { return request_time_; }
+const char *Request::GetIdData() const { return table_->GetIdData(row_); }
 
-std::string Request::GetOrigin() const { return origin_; }
+size_t Request::GetIdLength() const { return table_->GetIdLength(row_); }
 
-std::string Request::GetDestination() const { return destination_; }
+size_t Request::GetRow() const { return row_; }
+
+long Request::GetRequestTime() const { return table_->GetTime(row_); }
+
+Point Request::GetOrigin() const { return table_->GetOrigin(row_); }
+
+Point Request::GetDestination() const { return table_->GetDestination(row_); }
+
+double Request::GetDirectDistance() const {
+  return table_->GetDirectDistance(row_);
+}
 
 RequestState Request::GetState() const { return state_; }
 
 Ride *Request::GetAssociatedRide() const { return associated_ride_; }
 
-void Request::SetId(std::string id) { id_ = id; }
+void Request::SetId(std::string id) {
+  table_->SetId(row_, id.data(), id.size());
+}
 
-void Request::SetRequestTime(long time) { request_time_ = time; }
+void Request::SetRequestTime(long time) { table_->SetTime(row_, time); }
 
-void Request::SetOrigin(std::string origin) { origin_ = origin; }
+void Request::SetOrigin(Point origin) { table_->SetOrigin(row_, origin); }
 
-void Request::SetDestination(std::string dest) { destination_ = dest; }
+void Request::SetDestination(Point dest) {
+  table_->SetDestination(row_, dest);
+}
 
 void Request::SetAssociatedRide(Ride *ride) { associated_ride_ = ride; }
 
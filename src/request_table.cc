@@ -0,0 +1,108 @@
+#include "request_table.h"
+
+RequestTable::RequestTable() {}
+
+size_t RequestTable::AppendIdChars(const char *id, size_t id_length) {
+  size_t start = id_chars_.size();
+  for (size_t i = 0; i < id_length; ++i) {
+    id_chars_.push_back(id[i]);
+  }
+  return start;
+}
+
+size_t RequestTable::Append(const char *id, size_t id_length, long time,
+                            Point origin, Point dest) {
+  id_starts_.push_back(AppendIdChars(id, id_length));
+  id_lengths_.push_back(id_length);
+  times_.push_back(time);
+  origin_x_.push_back(origin.x);
+  origin_y_.push_back(origin.y);
+  dest_x_.push_back(dest.x);
+  dest_y_.push_back(dest.y);
+  direct_.push_back(CalculateDistance(origin, dest));
+  return times_.size() - 1;
+}
+
+void RequestTable::reserve(size_t rows) {
+  times_.reserve(rows);
+  origin_x_.reserve(rows);
+  origin_y_.reserve(rows);
+  dest_x_.reserve(rows);
+  dest_y_.reserve(rows);
+  direct_.reserve(rows);
+  id_starts_.reserve(rows);
+  id_lengths_.reserve(rows);
+}
+
+void RequestTable::clear() {
+  times_.clear();
+  origin_x_.clear();
+  origin_y_.clear();
+  dest_x_.clear();
+  dest_y_.clear();
+  direct_.clear();
+  id_starts_.clear();
+  id_lengths_.clear();
+  id_chars_.clear();
+}
+
+size_t RequestTable::size() const { return times_.size(); }
+
+std::string RequestTable::GetId(size_t row) const {
+  return std::string(GetIdData(row), GetIdLength(row));
+}
+
+const char *RequestTable::GetIdData(size_t row) const {
+  return id_chars_.begin() + id_starts_.unchecked_at(row);
+}
+
+size_t RequestTable::GetIdLength(size_t row) const {
+  return id_lengths_.unchecked_at(row);
+}
+
+long RequestTable::GetTime(size_t row) const {
+  return times_.unchecked_at(row);
+}
+
+Point RequestTable::GetOrigin(size_t row) const {
+  return Point(origin_x_.unchecked_at(row), origin_y_.unchecked_at(row));
+}
+
+Point RequestTable::GetDestination(size_t row) const {
+  return Point(dest_x_.unchecked_at(row), dest_y_.unchecked_at(row));
+}
+
+double RequestTable::GetDirectDistance(size_t row) const {
+  return direct_.unchecked_at(row);
+}
+
+const double *RequestTable::GetOriginXData() const {
+  return origin_x_.begin();
+}
+
+const double *RequestTable::GetOriginYData() const {
+  return origin_y_.begin();
+}
+
+const double *RequestTable::GetDestXData() const { return dest_x_.begin(); }
+
+const double *RequestTable::GetDestYData() const { return dest_y_.begin(); }
+
+void RequestTable::SetId(size_t row, const char *id, size_t id_length) {
+  id_starts_[row] = AppendIdChars(id, id_length);
+  id_lengths_[row] = id_length;
+}
+
+void RequestTable::SetTime(size_t row, long time) { times_[row] = time; }
+
+void RequestTable::SetOrigin(size_t row, Point origin) {
+  origin_x_[row] = origin.x;
+  origin_y_[row] = origin.y;
+  direct_[row] = CalculateDistance(origin, GetDestination(row));
+}
+
+void RequestTable::SetDestination(size_t row, Point dest) {
+  dest_x_[row] = dest.x;
+  dest_y_[row] = dest.y;
+  direct_[row] = CalculateDistance(GetOrigin(row), dest);
+}
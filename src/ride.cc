@@ -1,67 +1,212 @@
 #include "ride.h"
 
-#include <cmath>
-#include <iostream>
-#include <sstream>
+#include <stdexcept>
 
+#include "arena.h"
+#include "point.h"
 #include "request.h"
 
-Ride::Ride() : total_distance_(0.0), total_duration_(0.0), efficiency_(0.0) {}
+namespace {
 
-Ride::~Ride() {
-  for (size_t i = 0; i < segments_.size(); ++i) {
-    delete segments_[i];
+const size_t kInitialSlots = 4; // Request slots of a growing ride at first.
+
+/**
+ * @brief Moves the first `count` elements of a heap array into a new one of
+ * `size` elements, and frees the old array.
+ */
+template <typename T> T *Regrow(T *old, size_t count, size_t size) {
+  T *grown = new T[size];
+  for (size_t i = 0; i < count; ++i) {
+    grown[i] = old[i];
   }
+  delete[] old;
+  return grown;
 }
 
-void Ride::AddRequest(Request *request) { requests_.push_back(request); }
+} // namespace
 
-void Ride::AddSegment(Segment *segment) {
-  segments_.push_back(segment);
-  total_distance_ += segment->GetDistance();
-  total_duration_ += segment->GetTime();
+Ride::Ride() : grows_(true) {
+  Init(nullptr, 0, nullptr, nullptr, nullptr, nullptr);
 }
 
-// Helper to calculate distance between two coordinate strings
-double calcDist(std::string c1, std::string c2) {
-  double x1, y1, x2, y2;
-  std::stringstream ss1(c1);
-  ss1 >> x1 >> y1;
-  std::stringstream ss2(c2);
-  ss2 >> x2 >> y2;
-  return std::sqrt(std::pow(x2 - x1, 2) + std::pow(y2 - y1, 2));
+Ride::Ride(Arena *arena) : grows_(true) {
+  Init(arena, 0, nullptr, nullptr, nullptr, nullptr);
 }
 
-void Ride::UpdateRoute(double speed) {
-  // Clear existing segments
-  for (size_t i = 0; i < segments_.size(); ++i) {
-    delete segments_[i];
+Ride::Ride(Arena *arena, size_t slots, Request **requests, Stop *stops,
+           Segment **segments, double *legs)
+    : grows_(false) {
+  Init(arena, slots, requests, stops, segments, legs);
+}
+
+Ride::~Ride() {
+  ClearRoute();
+  if (grows_) {
+    delete[] requests_;
+    delete[] stops_;
+    delete[] segments_;
+    delete[] pickup_legs_;
+  }
+}
+
+void Ride::Init(Arena *arena, size_t slots, Request **requests, Stop *stops,
+                Segment **segments, double *legs) {
+  requests_ = requests;
+  stops_ = stops;
+  segments_ = segments;
+  slots_ = slots;
+  request_count_ = 0;
+  stop_count_ = 0;
+  segment_count_ = 0;
+  arena_ = arena;
+  total_distance_ = 0.0;
+  total_duration_ = 0.0;
+  efficiency_ = 0.0;
+  sum_direct_ = 0.0;
+  pickup_chain_ = 0.0;
+  dropoff_chain_ = 0.0;
+  route_distance_ = 0.0;
+  pickup_legs_ = legs;
+  dropoff_legs_ = (slots > 0) ? legs + (slots - 1) : legs;
+  displacement_ = 0.0;
+}
+
+void Ride::GrowSlots() {
+  if (!grows_)
+    throw std::length_error("Ride is full");
+
+  // The legs hold the pickup legs, then the drop-off legs from slots - 1 on.
+  size_t slots = (slots_ == 0) ? kInitialSlots : 2 * slots_;
+  size_t leg_count = (request_count_ > 0) ? request_count_ - 1 : 0;
+  double *legs = new double[2 * slots];
+  for (size_t i = 0; i < leg_count; ++i) {
+    legs[i] = pickup_legs_[i];
+    legs[slots - 1 + i] = dropoff_legs_[i];
+  }
+  delete[] pickup_legs_;
+  pickup_legs_ = legs;
+  dropoff_legs_ = legs + (slots - 1);
+
+  Stop *old_stops = stops_;
+  requests_ = Regrow(requests_, request_count_, slots);
+  stops_ = Regrow(stops_, stop_count_, 2 * slots);
+  segments_ = Regrow(segments_, segment_count_, 2 * slots - 1);
+  slots_ = slots;
+  for (int i = 0; i < segment_count_; ++i) {
+    Segment *segment = segments_[i];
+    segment->SetStart(stops_ + (segment->GetStart() - old_stops));
+    segment->SetEnd(stops_ + (segment->GetEnd() - old_stops));
   }
-  segments_.clear();
+}
+
+void Ride::ClearRoute() {
+  if (arena_ == nullptr) {
+    for (int i = 0; i < segment_count_; ++i) {
+      delete segments_[i];
+    }
+  }
+  segment_count_ = 0;
+  stop_count_ = 0;
   total_distance_ = 0;
   total_duration_ = 0;
+}
+
+Stop *Ride::NewStop(const Request *request, StopType type) {
+  Stop *stop = &stops_[stop_count_++];
+  *stop = Stop(request, type);
+  return stop;
+}
+
+void Ride::AddRequest(Request *request) {
+  CommitInsertion(request, EvaluateInsertion(request));
+}
 
-  if (requests_.empty())
+InsertionResult Ride::EvaluateInsertion(const Request *request) const {
+  InsertionResult result;
+  Point origin = request->GetOrigin();
+  Point dest = request->GetDestination();
+
+  double direct = request->GetDirectDistance();
+  result.sum_direct = sum_direct_ + direct;
+  if (request_count_ == 0) {
+    result.pickup_chain = 0.0;
+    result.dropoff_chain = 0.0;
+    result.pickup_leg = 0.0;
+    result.dropoff_leg = 0.0;
+    result.displacement = direct;
+    result.route_distance = direct;
+  } else {
+    // Only the legs that reach the new stops are computed.
+    const Request *last = requests_[request_count_ - 1];
+    result.pickup_leg = CalculateDistance(last->GetOrigin(), origin);
+    result.dropoff_leg = CalculateDistance(last->GetDestination(), dest);
+    result.displacement =
+        CalculateDistance(origin, requests_[0]->GetDestination());
+    result.pickup_chain = pickup_chain_ + result.pickup_leg;
+    result.dropoff_chain = dropoff_chain_ + result.dropoff_leg;
+    result.route_distance =
+        result.pickup_chain + result.displacement + result.dropoff_chain;
+  }
+
+  result.distance_delta = result.route_distance - route_distance_;
+  result.efficiency = (result.route_distance == 0)
+                          ? 0.0
+                          : result.sum_direct / result.route_distance;
+  return result;
+}
+
+void Ride::CommitInsertion(Request *request, const InsertionResult &result) {
+  if ((size_t)request_count_ == slots_)
+    GrowSlots();
+  if (request_count_ > 0) {
+    pickup_legs_[request_count_ - 1] = result.pickup_leg;
+    dropoff_legs_[request_count_ - 1] = result.dropoff_leg;
+  }
+  requests_[request_count_++] = request;
+  displacement_ = result.displacement;
+  sum_direct_ = result.sum_direct;
+  pickup_chain_ = result.pickup_chain;
+  dropoff_chain_ = result.dropoff_chain;
+  route_distance_ = result.route_distance;
+  efficiency_ = result.efficiency;
+}
+
+void Ride::AddSegment(Segment *segment) {
+  if ((size_t)segment_count_ + 1 >= 2 * slots_)
+    GrowSlots();
+  segments_[segment_count_++] = segment;
+  total_distance_ += segment->GetDistance();
+  total_duration_ += segment->GetTime();
+}
+
+void Ride::UpdateRoute(double speed) {
+  // Clear existing stops and segments
+  ClearRoute();
+
+  if (request_count_ == 0)
     return;
 
   // Create Stops
-  Vector<Stop *> stops;
   // Pickups
-  for (size_t i = 0; i < requests_.size(); ++i) {
-    stops.push_back(new Stop(requests_[i]->GetOrigin(), StopType::kPickup,
-                             requests_[i]->GetId()));
+  for (int i = 0; i < request_count_; ++i) {
+    NewStop(requests_[i], StopType::kPickup);
   }
   // Dropoffs
-  for (size_t i = 0; i < requests_.size(); ++i) {
-    stops.push_back(new Stop(requests_[i]->GetDestination(), StopType::kDropoff,
-                             requests_[i]->GetId()));
+  for (int i = 0; i < request_count_; ++i) {
+    NewStop(requests_[i], StopType::kDropoff);
   }
 
-  // Create Segments connecting stops
-  for (size_t i = 0; i < stops.size() - 1; ++i) {
-    Stop *start = stops[i];
-    Stop *end = stops[i + 1];
-    double dist = calcDist(start->GetCoordinate(), end->GetCoordinate());
+  // Create Segments connecting stops, with the legs cached on insertion
+  int last_pickup = request_count_ - 1;
+  for (int i = 0; i + 1 < stop_count_; ++i) {
+    Stop *start = &stops_[i];
+    Stop *end = &stops_[i + 1];
+    double dist = displacement_;
+    if (i < last_pickup) {
+      dist = pickup_legs_[i];
+    } else if (i > last_pickup) {
+      dist = dropoff_legs_[i - last_pickup - 1];
+    }
     double time = (speed > 0) ? dist / speed : 0;
 
     SegmentType type = SegmentType::kDisplacement;
@@ -76,7 +221,9 @@ void Ride::UpdateRoute(double speed) {
       type = SegmentType::kDisplacement;
     }
 
-    AddSegment(new Segment(start, end, dist, time, type));
+    AddSegment((arena_ != nullptr)
+                   ? arena_->New<Segment>(start, end, dist, time, type)
+                   : new Segment(start, end, dist, time, type));
   }
 
   CalculateEfficiency();
@@ -89,28 +236,36 @@ void Ride::CalculateEfficiency() {
   }
 
   // Efficiency = (Sum of Direct Distances) / Total Distance
-  double sum_direct = 0.0;
-  for (size_t i = 0; i < requests_.size(); ++i) {
-    sum_direct +=
-        calcDist(requests_[i]->GetOrigin(), requests_[i]->GetDestination());
-  }
-
-  efficiency_ = sum_direct / total_distance_;
+  efficiency_ = sum_direct_ / total_distance_;
 }
 
-int Ride::GetDemandCount() const { return requests_.size(); }
+int Ride::GetDemandCount() const { return request_count_; }
 
 std::string Ride::GetDemandId(int index) const {
-  if (index >= 0 && index < (int)requests_.size()) {
+  if (index >= 0 && index < request_count_) {
     return requests_[index]->GetId();
   }
   return "";
 }
 
-int Ride::GetSegmentCount() const { return segments_.size(); }
+Request *Ride::GetRequest(int index) const {
+  if (index >= 0 && index < request_count_) {
+    return requests_[index];
+  }
+  return nullptr;
+}
+
+Request *Ride::GetFirstRequest() const {
+  if (request_count_ == 0) {
+    return nullptr;
+  }
+  return requests_[0];
+}
+
+int Ride::GetSegmentCount() const { return segment_count_; }
 
 Segment *Ride::GetSegment(int index) const {
-  if (index >= 0 && index < (int)segments_.size()) {
+  if (index >= 0 && index < segment_count_) {
     return segments_[index];
   }
   return nullptr;
@@ -118,6 +273,8 @@ Segment *Ride::GetSegment(int index) const {
 
 double Ride::GetTotalDistance() const { return total_distance_; }
 
+double Ride::GetRouteDistance() const { return route_distance_; }
+
 double Ride::GetTotalDuration() const { return total_duration_; }
 
 double Ride::GetEfficiency() const { return efficiency_; }
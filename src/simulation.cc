@@ -0,0 +1,214 @@
+#include "simulation.h"
+
+#include <chrono>
+#include <stdexcept>
+
+#include "calendar_queue.h"
+#include "event.h"
+#include "min_heap.h"
+#include "output_writer.h"
+#include "point.h"
+#include "request.h"
+#include "ride.h"
+#include "segment.h"
+#include "stop.h"
+
+void WriteRide(const Ride *r, OutputWriter &output) {
+  // Output Results
+  double start_time = 0;
+  // Re-find start time for output
+  Request *first_req = r->GetFirstRequest();
+  start_time = (double)first_req->GetRequestTime();
+  double duration = r->GetTotalDuration();
+  double end_time = start_time + duration;
+
+  output.WriteFixed(end_time, 2);
+  output.WriteChar(' ');
+  output.WriteFixed(r->GetTotalDistance(), 2);
+  output.WriteChar(' ');
+  output.WriteInt(r->GetSegmentCount() + 1);
+  output.WriteChar(' ');
+
+  for (int j = 0; j < r->GetSegmentCount(); ++j) {
+    Segment *s = r->GetSegment(j);
+    if (j == 0) {
+      Point p = s->GetStart()->GetCoordinate();
+      output.WriteFixed(p.x, 2);
+      output.WriteChar(' ');
+      output.WriteFixed(p.y, 2);
+    }
+    Point p = s->GetEnd()->GetCoordinate();
+    output.WriteChar(' ');
+    output.WriteFixed(p.x, 2);
+    output.WriteChar(' ');
+    output.WriteFixed(p.y, 2);
+  }
+  output.WriteChar('\n');
+}
+
+double GetCompletionTime(const Ride *r) {
+  double time = (double)r->GetFirstRequest()->GetRequestTime();
+  int segment_count = r->GetSegmentCount();
+  for (int j = 0; j < segment_count; ++j) {
+    time += r->GetSegment(j)->GetTime();
+  }
+  return time;
+}
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Computes the seconds elapsed between two time points.
+ */
+double SecondsBetween(Clock::time_point start, Clock::time_point end) {
+  return std::chrono::duration<double>(end - start).count();
+}
+
+/**
+ * @brief Runs Phases 2 and 3 on a given priority queue type.
+ * @tparam Queue A priority queue of Events with the MinHeap interface (push,
+ * top, pop, replace_top, empty and reserve).
+ */
+template <typename Queue>
+void Simulate(const Vector<Ride *> &rides, OutputWriter &output,
+              SimulationCounters &counters) {
+  Clock::time_point start = Clock::now();
+  Queue event_queue;
+  event_queue.reserve(rides.size());
+
+  // Phase 2: Scheduling
+  // Schedule the first event for each formed ride.
+  for (size_t k = 0; k < rides.size(); ++k) {
+    Ride *r = rides.unchecked_at(k);
+
+    // Find the start time based on the first request's time
+    Request *first_req = r->GetFirstRequest();
+
+    Event e;
+    e.time = (double)first_req->GetRequestTime();
+    e.sequence = MakeEventSequence(k, 0); // Start at the beginning of the route
+    event_queue.push(e);
+  }
+
+  // Phase 3: Simulation Loop
+  Clock::time_point scheduled = Clock::now();
+  unsigned long long events = 0;
+  double current_time = 0;
+  while (!event_queue.empty()) {
+    Event e = event_queue.top();
+    ++events;
+
+    current_time = e.time;
+    Ride *r = rides.unchecked_at(e.GetRideIndex());
+
+    // If it has more segments to process
+    if (e.GetStopIndex() < r->GetSegmentCount()) {
+      Segment *seg = r->GetSegment(e.GetStopIndex());
+
+      // Calculate travel time for this segment
+      double travel_time = seg->GetTime();
+
+      // Schedule next event (arrival at next stop)
+      Event next_event;
+      next_event.time = current_time + travel_time;
+      // Same ride, next stop: the stop index is in the low bits.
+      next_event.sequence = e.sequence + 1;
+      // The successor takes the popped event's place in a single sift.
+      event_queue.replace_top(next_event);
+    } else {
+      event_queue.pop();
+
+      // Ride Finished
+      WriteRide(r, output);
+    }
+  }
+
+  counters.schedule_seconds = SecondsBetween(start, scheduled);
+  counters.simulate_seconds = SecondsBetween(scheduled, Clock::now());
+  counters.events = events;
+  // Every event is replaced by its successor or removed, so the queue is
+  // largest right after Phase 2.
+  counters.max_queue_size = rides.size();
+}
+
+/**
+ * @brief Runs Phases 2 and 3 with one event per ride, scheduled at its
+ * completion (see GetCompletionTime).
+ *
+ * @tparam Queue A priority queue of Events with the MinHeap interface.
+ */
+template <typename Queue>
+void SimulateCompletions(const Vector<Ride *> &rides, OutputWriter &output,
+                         SimulationCounters &counters) {
+  Clock::time_point start = Clock::now();
+  Queue event_queue;
+  event_queue.reserve(rides.size());
+
+  // Phase 2: Scheduling
+  // Schedule the completion of each formed ride.
+  for (size_t k = 0; k < rides.size(); ++k) {
+    Ride *r = rides.unchecked_at(k);
+
+    Event e;
+    e.time = GetCompletionTime(r);
+    // The stop index of the last per-segment event, which ties break on.
+    e.sequence = MakeEventSequence(k, r->GetSegmentCount());
+    event_queue.push(e);
+  }
+
+  // Phase 3: Simulation Loop
+  Clock::time_point scheduled = Clock::now();
+  while (!event_queue.empty()) {
+    Ride *r = rides.unchecked_at(event_queue.top().GetRideIndex());
+    event_queue.pop();
+    WriteRide(r, output);
+  }
+
+  counters.schedule_seconds = SecondsBetween(start, scheduled);
+  counters.simulate_seconds = SecondsBetween(scheduled, Clock::now());
+  counters.events = rides.size();
+  counters.max_queue_size = rides.size();
+}
+
+/**
+ * @brief Runs Phases 2 and 3 in a given mode on a given priority queue type.
+ */
+template <typename Queue>
+void SimulateWith(SimulationMode mode, const Vector<Ride *> &rides,
+                  OutputWriter &output, SimulationCounters &counters) {
+  if (mode == SimulationMode::kFast) {
+    SimulateCompletions<Queue>(rides, output, counters);
+  } else {
+    Simulate<Queue>(rides, output, counters);
+  }
+}
+
+} // namespace
+
+void SimulateRides(SimulationMode mode, EventQueueKind queue_kind,
+                   const Vector<Ride *> &rides, OutputWriter &output,
+                   SimulationCounters *counters) {
+  if (rides.size() > kMaxEventRides)
+    throw std::length_error("Too many rides for the event scheduler");
+
+  SimulationCounters unused;
+  SimulationCounters &measured = (counters != nullptr) ? *counters : unused;
+
+  switch (queue_kind) {
+  case EventQueueKind::kQuaternaryHeap:
+    SimulateWith<MinHeap<Event, 4> >(mode, rides, output, measured);
+    break;
+  case EventQueueKind::kOctonaryHeap:
+    SimulateWith<MinHeap<Event, 8> >(mode, rides, output, measured);
+    break;
+  case EventQueueKind::kCalendar:
+    SimulateWith<CalendarQueue<Event> >(mode, rides, output, measured);
+    break;
+  case EventQueueKind::kBinaryHeap:
+  default:
+    SimulateWith<MinHeap<Event, 2> >(mode, rides, output, measured);
+    break;
+  }
+}
@@ -0,0 +1,136 @@
+#include "spatial_grid.h"
+
+#include <cmath>
+
+namespace {
+
+// Cell coordinates are clamped to this magnitude to stay representable.
+const double kMaxCell = 4.0e18;
+
+size_t HashCell(long long cell_x, long long cell_y) {
+  unsigned long long hash = (unsigned long long)cell_x * 0x9E3779B97F4A7C15ULL;
+  hash ^= (unsigned long long)cell_y * 0xC2B2AE3D27D4EB4FULL;
+  hash ^= hash >> 29;
+  return (size_t)hash;
+}
+
+} // namespace
+
+SpatialGrid::SpatialGrid(double cell_size)
+    : cell_size_(cell_size > 0 ? cell_size : 1.0), slots_(nullptr),
+      slot_count_(0) {}
+
+SpatialGrid::~SpatialGrid() {
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    delete buckets_[i];
+  }
+  delete[] slots_;
+}
+
+long long SpatialGrid::CellOf(double value) const {
+  double cell = std::floor(value / cell_size_);
+  if (!(cell > -kMaxCell))
+    return (long long)-kMaxCell;
+  if (cell > kMaxCell)
+    return (long long)kMaxCell;
+  return (long long)cell;
+}
+
+size_t SpatialGrid::Probe(long long cell_x, long long cell_y) const {
+  size_t mask = slot_count_ - 1;
+  size_t pos = HashCell(cell_x, cell_y) & mask;
+  while (slots_[pos] != -1) {
+    const Bucket *bucket = buckets_[slots_[pos]];
+    if (bucket->cell_x == cell_x && bucket->cell_y == cell_y)
+      return pos;
+    pos = (pos + 1) & mask;
+  }
+  return pos;
+}
+
+void SpatialGrid::Rehash(size_t new_slot_count) {
+  delete[] slots_;
+  slots_ = new int[new_slot_count];
+  slot_count_ = new_slot_count;
+  for (size_t i = 0; i < slot_count_; ++i) {
+    slots_[i] = -1;
+  }
+  for (size_t i = 0; i < buckets_.size(); ++i) {
+    slots_[Probe(buckets_[i]->cell_x, buckets_[i]->cell_y)] = (int)i;
+  }
+}
+
+void SpatialGrid::Insert(size_t row, Point point) {
+  // Keep the load factor at or below one half.
+  if ((buckets_.size() + 1) * 2 > slot_count_) {
+    Rehash(slot_count_ == 0 ? 64 : slot_count_ * 2);
+  }
+
+  long long cell_x = CellOf(point.x);
+  long long cell_y = CellOf(point.y);
+  size_t pos = Probe(cell_x, cell_y);
+  if (slots_[pos] == -1) {
+    Bucket *bucket = new Bucket();
+    bucket->cell_x = cell_x;
+    bucket->cell_y = cell_y;
+    slots_[pos] = (int)buckets_.size();
+    buckets_.push_back(bucket);
+  }
+  buckets_[slots_[pos]]->rows.push_back(row);
+}
+
+void SpatialGrid::QueryNeighborhood(Point point, size_t min_row,
+                                    const Vector<char> &removed,
+                                    Vector<size_t> &rows) {
+  rows.clear();
+  if (slot_count_ == 0)
+    return;
+
+  // Gather the non-empty neighboring buckets, dropping stale rows.
+  Vector<size_t> *lists[9];
+  size_t heads[9];
+  int list_count = 0;
+
+  long long cell_x = CellOf(point.x);
+  long long cell_y = CellOf(point.y);
+  for (long long dx = -1; dx <= 1; ++dx) {
+    for (long long dy = -1; dy <= 1; ++dy) {
+      int index = slots_[Probe(cell_x + dx, cell_y + dy)];
+      if (index == -1)
+        continue;
+
+      Vector<size_t> &bucket_rows = buckets_[index]->rows;
+      size_t kept = 0;
+      for (size_t i = 0; i < bucket_rows.size(); ++i) {
+        size_t row = bucket_rows.unchecked_at(i);
+        if (row >= min_row && removed.unchecked_at(row) == 0) {
+          bucket_rows.unchecked_at(kept++) = row;
+        }
+      }
+      while (bucket_rows.size() > kept) {
+        bucket_rows.pop_back();
+      }
+
+      if (kept > 0) {
+        lists[list_count] = &bucket_rows;
+        heads[list_count] = 0;
+        ++list_count;
+      }
+    }
+  }
+
+  // Each bucket is sorted, so a k-way merge yields the rows in order.
+  for (;;) {
+    int best = -1;
+    for (int k = 0; k < list_count; ++k) {
+      if (heads[k] < lists[k]->size() &&
+          (best == -1 || lists[k]->unchecked_at(heads[k]) <
+                             lists[best]->unchecked_at(heads[best]))) {
+        best = k;
+      }
+    }
+    if (best == -1)
+      break;
+    rows.push_back(lists[best]->unchecked_at(heads[best]++));
+  }
+}
@@ -0,0 +1,55 @@
+#include "stats.h"
+
+#include <cstdio>
+
+#include "ride.h"
+
+void RunStats::RecordRides(const Vector<Ride *> &rides) {
+  for (size_t k = 0; k < rides.size(); ++k) {
+    size_t riders = (size_t)rides.unchecked_at(k)->GetDemandCount();
+    while (ride_sizes.size() <= riders) {
+      ride_sizes.push_back(0);
+    }
+    ++ride_sizes.unchecked_at(riders);
+  }
+}
+
+unsigned long long RunStats::GetRideCount() const {
+  unsigned long long rides = 0;
+  for (size_t riders = 0; riders < ride_sizes.size(); ++riders) {
+    rides += ride_sizes[riders];
+  }
+  return rides;
+}
+
+void RunStats::Print() const {
+  unsigned long long rides = GetRideCount();
+
+  std::fprintf(stderr, "requests               %zu\n", requests);
+  std::fprintf(stderr, "rides                  %llu\n", rides);
+  for (size_t riders = 1; riders < ride_sizes.size(); ++riders) {
+    std::fprintf(stderr, "  %2zu riders            %llu (%.1f%%)\n", riders,
+                 ride_sizes[riders],
+                 rides > 0 ? 100.0 * ride_sizes[riders] / rides : 0.0);
+  }
+  std::fprintf(stderr, "rejections\n");
+  std::fprintf(stderr, "  capacity             %llu\n",
+               grouping.capacity_rejections);
+  std::fprintf(stderr, "  distance             %llu\n",
+               grouping.distance_rejections);
+  std::fprintf(stderr, "  efficiency           %llu\n",
+               grouping.efficiency_rejections);
+  std::fprintf(stderr, "  max delay            %llu\n",
+               grouping.delay_rejections);
+  std::fprintf(stderr, "events processed       %llu\n", simulation.events);
+  std::fprintf(stderr, "queue high-water mark  %zu\n",
+               simulation.max_queue_size);
+  std::fprintf(stderr, "phase seconds\n");
+  std::fprintf(stderr, "  read                 %.6f\n", read_seconds);
+  std::fprintf(stderr, "  group                %.6f\n", group_seconds);
+  std::fprintf(stderr, "  schedule             %.6f\n",
+               simulation.schedule_seconds);
+  std::fprintf(stderr, "  simulate             %.6f\n",
+               simulation.simulate_seconds);
+  std::fprintf(stderr, "  output               %.6f\n", output_seconds);
+}
@@ -1,20 +1,26 @@
 #include "stop.h"
 
-Stop::Stop() {}
+#include "request.h"
 
-Stop::Stop(std::string coord, StopType t, std::string pid)
-    : coordinate_(coord), type_(t), passenger_id_(pid) {}
+Stop::Stop() : request_(nullptr), type_(StopType::kPickup) {}
 
-Stop::~Stop() {}
+Stop::Stop(const Request *request, StopType t) : request_(request), type_(t) {}
 
-std::string Stop::GetCoordinate() const { return coordinate_; }
+Point Stop::GetCoordinate() const {
+  if (request_ == nullptr)
+    return Point();
+  return (type_ == StopType::kPickup) ? request_->GetOrigin()
+                                      : request_->GetDestination();
+}
 
 StopType Stop::GetType() const { return type_; }
 
-std::string Stop::GetPassengerId() const { return passenger_id_; }
+const Request *Stop::GetRequest() const { return request_; }
 
-void Stop::SetCoordinate(std::string coord) { coordinate_ = coord; }
+std::string Stop::GetPassengerId() const {
+  return (request_ != nullptr) ? request_->GetId() : std::string();
+}
 
 void Stop::SetType(StopType t) { type_ = t; }
 
-void Stop::SetPassengerId(std::string pid) { passenger_id_ = pid; }
+void Stop::SetRequest(const Request *request) { request_ = request; }
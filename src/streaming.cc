@@ -0,0 +1,208 @@
+#include "streaming.h"
+
+#include <stdexcept>
+
+#include "arena.h"
+#include "calendar_queue.h"
+#include "event.h"
+#include "grouping.h"
+#include "input_reader.h"
+#include "min_heap.h"
+#include "output_writer.h"
+#include "request.h"
+#include "request_table.h"
+#include "ride.h"
+#include "simulation.h"
+#include "simulation_params.h"
+#include "stats.h"
+#include "vector.h"
+
+namespace {
+
+const size_t kBatchRows = 1 << 16; // Requests read per batch.
+
+/**
+ * @brief A batch of requests and the rides formed from them.
+ *
+ * The rides point into the batch's requests and arena, so a batch lives
+ * until every one of its rides has been written.
+ */
+struct Batch {
+  RequestTable table;       // The requests of the batch.
+  Vector<Request> requests; // One view per table row.
+  Arena arena;              // Owns the rides of the batch.
+  Vector<Ride *> rides;     // Rides formed in the batch.
+  size_t first_ride;        // Stream-wide index of rides[0].
+  size_t pending;           // Rides not written yet.
+};
+
+/**
+ * @brief Appends a row of one table to another.
+ */
+void CopyRow(const RequestTable &from, size_t row, RequestTable &to) {
+  to.Append(from.GetIdData(row), from.GetIdLength(row), from.GetTime(row),
+            from.GetOrigin(row), from.GetDestination(row));
+}
+
+/**
+ * @brief Finds the batch that formed a ride.
+ * @param batches The live batches, ordered by first ride.
+ * @param head Index of the oldest live batch.
+ * @param ride_index The stream-wide index of the ride.
+ * @return The batch, which must be live.
+ */
+Batch *FindBatch(const Vector<Batch *> &batches, size_t head,
+                 size_t ride_index) {
+  size_t low = head;
+  size_t high = batches.size() - 1;
+  while (low < high) {
+    size_t middle = low + (high - low + 1) / 2;
+    if (batches.unchecked_at(middle)->first_ride <= ride_index) {
+      low = middle;
+    } else {
+      high = middle - 1;
+    }
+  }
+  return batches.unchecked_at(low);
+}
+
+/**
+ * @brief Runs the streaming simulation on a given priority queue type.
+ * @tparam Queue A priority queue of Events with the MinHeap interface.
+ */
+template <typename Queue>
+void Stream(const SimulationOptions &options, const SimulationParams &params,
+            InputReader &reader, size_t count, OutputWriter &output,
+            RunStats *stats) {
+  Stopwatch stopwatch;
+  RunStats unused;
+  RunStats &measured = (stats != nullptr) ? *stats : unused;
+  Queue event_queue;
+  Vector<Batch *> batches; // Live batches, oldest first, from batches[head].
+  size_t head = 0;
+  RequestTable carry;      // Requests deferred to the next batch.
+  Vector<size_t> deferred; // Their rows in the current batch.
+  size_t read_count = 0;
+  size_t ride_count = 0;
+
+  bool done = false;
+  while (!done) {
+    Batch *batch = new Batch;
+    batch->first_ride = ride_count;
+    batch->pending = 0;
+    batches.push_back(batch);
+
+    // Phase 1: Grouping
+    // The deferred requests come first, followed by the next batch.
+    RequestTable &table = batch->table;
+    for (size_t row = 0; row < carry.size(); ++row) {
+      CopyRow(carry, row, table);
+    }
+    size_t wanted = count - read_count;
+    if (wanted > kBatchRows)
+      wanted = kBatchRows;
+    size_t read = reader.ReadRequests(table, wanted);
+    read_count += read;
+    measured.requests += read;
+    done = read < wanted || read_count == count;
+
+    batch->requests.reserve(table.size());
+    for (size_t row = 0; row < table.size(); ++row) {
+      batch->requests.emplace_back(&table, row);
+    }
+    measured.read_seconds += stopwatch.Lap();
+
+    deferred.clear();
+    GroupRequests(options.grouping, table, batch->requests, params,
+                  batch->arena, batch->rides, done ? nullptr : &deferred,
+                  (stats != nullptr) ? &stats->grouping : nullptr);
+    if (stats != nullptr)
+      stats->RecordRides(batch->rides);
+
+    carry.clear();
+    for (size_t k = 0; k < deferred.size(); ++k) {
+      CopyRow(table, deferred.unchecked_at(k), carry);
+    }
+    measured.group_seconds += stopwatch.Lap();
+
+    // Phase 2: Scheduling
+    size_t ride_total = ride_count + batch->rides.size();
+    if (ride_total < ride_count || ride_total > kMaxEventRides)
+      throw std::length_error("Too many rides for the event scheduler");
+    for (size_t k = 0; k < batch->rides.size(); ++k) {
+      Ride *r = batch->rides.unchecked_at(k);
+      Event e;
+      e.time = GetCompletionTime(r);
+      e.sequence = MakeEventSequence(ride_count + k, r->GetSegmentCount());
+      event_queue.push(e);
+    }
+    ride_count = ride_total;
+    batch->pending = batch->rides.size();
+    if (event_queue.size() > measured.simulation.max_queue_size)
+      measured.simulation.max_queue_size = event_queue.size();
+    measured.simulation.events += batch->rides.size();
+    measured.simulation.schedule_seconds += stopwatch.Lap();
+
+    // Phase 3: Simulation
+    // Rides formed later start at or after the first request not grouped
+    // yet, and break ties after every ride formed so far.
+    double horizon = 0;
+    if (!done) {
+      horizon = (carry.size() > 0) ? (double)carry.GetTime(0)
+                                   : (double)table.GetTime(table.size() - 1);
+    }
+    while (!event_queue.empty() &&
+           (done || event_queue.top().time <= horizon)) {
+      size_t ride_index = event_queue.top().GetRideIndex();
+      event_queue.pop();
+      Batch *owner = FindBatch(batches, head, ride_index);
+      WriteRide(owner->rides.unchecked_at(ride_index - owner->first_ride),
+                output);
+      --owner->pending;
+    }
+    measured.simulation.simulate_seconds += stopwatch.Lap();
+
+    // Free the oldest batches once all of their rides are written.
+    while (head < batches.size() && batches.unchecked_at(head)->pending == 0) {
+      delete batches.unchecked_at(head);
+      ++head;
+    }
+    if (head > 0 && 2 * head >= batches.size()) {
+      size_t live = batches.size() - head;
+      for (size_t k = 0; k < live; ++k) {
+        batches.unchecked_at(k) = batches.unchecked_at(head + k);
+      }
+      while (batches.size() > live) {
+        batches.pop_back();
+      }
+      head = 0;
+    }
+  }
+
+  for (size_t k = head; k < batches.size(); ++k) {
+    delete batches.unchecked_at(k);
+  }
+}
+
+} // namespace
+
+void SimulateStream(const SimulationOptions &options,
+                    const SimulationParams &params, InputReader &reader,
+                    size_t count, OutputWriter &output, RunStats *stats) {
+  switch (options.event_queue) {
+  case EventQueueKind::kQuaternaryHeap:
+    Stream<MinHeap<Event, 4> >(options, params, reader, count, output, stats);
+    break;
+  case EventQueueKind::kOctonaryHeap:
+    Stream<MinHeap<Event, 8> >(options, params, reader, count, output, stats);
+    break;
+  case EventQueueKind::kCalendar:
+    Stream<CalendarQueue<Event> >(options, params, reader, count, output,
+                                  stats);
+    break;
+  case EventQueueKind::kBinaryHeap:
+  default:
+    Stream<MinHeap<Event, 2> >(options, params, reader, count, output, stats);
+    break;
+  }
+}
@@ -0,0 +1,318 @@
+/**
+ * @file workload_gen.cc
+ * @brief Synthetic workload generator for load testing.
+ *
+ * Writes a simulator input to stdout: the six simulation parameters, the
+ * number of requests and one request per line, in non-decreasing time order.
+ *
+ * Requests arrive as a Poisson process. With `--peak=A`, the rate follows a
+ * day of 1440 time units with a morning and an evening rush hour, rising to
+ * (1 + A) times the base rate at 8:00 and 18:00; the arrivals are drawn
+ * exactly by thinning. Timestamps are the integer part of the arrival times.
+ *
+ * Origins and destinations are drawn independently from a mixture: with
+ * probability `--hotspot-share`, around one of `--hotspots` centers, with
+ * normally distributed offsets of standard deviation `--hotspot-radius`; and
+ * otherwise uniformly over the square city. Hotspot k is chosen with weight
+ * 1 / (k + 1), so a few of them dominate, as in a real city.
+ *
+ * The random numbers come from a 64-bit Mersenne Twister with hand-written
+ * transforms rather than the standard distributions, whose algorithms vary
+ * between standard libraries. The transforms still call log1p, cos and exp,
+ * so a seed yields the same file wherever the same libm is used.
+ *
+ * Usage: workload_gen.out [--requests=N] [--seed=S] [--rate=R] [--peak=A]
+ *        [--city=L] [--hotspots=K] [--hotspot-share=P] [--hotspot-radius=D]
+ *        [--capacity=C] [--speed=V] [--max-wait=W] [--max-delay=D]
+ *        [--max-distance=D] [--min-efficiency=E] > input.txt
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+#include "output_writer.h"
+#include "point.h"
+#include "simulation_params.h"
+#include "vector.h"
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+const double kDayLength = 1440; // Time units per day.
+
+/**
+ * @brief Settings of the generated workload.
+ */
+struct WorkloadOptions {
+  long requests;         // Number of requests.
+  unsigned long seed;    // Random seed.
+  double rate;           // Base arrivals per time unit.
+  double peak;           // Extra rate at the rush hours, relative to rate.
+  double city;           // Side length of the city.
+  int hotspots;          // Number of hotspot centers.
+  double hotspot_share;  // Probability that a point is near a hotspot.
+  double hotspot_radius; // Standard deviation around a hotspot.
+  SimulationParams params;
+};
+
+/**
+ * @brief Parses a numeric option value.
+ * @param arg The whole argument.
+ * @param name The option name, including the trailing '='.
+ * @param[out] value Set to the parsed value on a match.
+ * @param[out] valid Cleared if the argument matches but is not a number.
+ * @return true if arg starts with name.
+ */
+bool MatchNumber(const char *arg, const char *name, double &value,
+                 bool &valid) {
+  size_t length = std::strlen(name);
+  if (std::strncmp(arg, name, length) != 0)
+    return false;
+  char *end;
+  value = std::strtod(arg + length, &end);
+  if (end == arg + length || *end != '\0')
+    valid = false;
+  return true;
+}
+
+bool ParseArguments(int argc, char **argv, WorkloadOptions &options) {
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    double value = 0;
+    bool valid = true;
+    if (MatchNumber(arg, "--requests=", value, valid)) {
+      options.requests = (long)value;
+      valid = valid && value >= 0;
+    } else if (MatchNumber(arg, "--seed=", value, valid)) {
+      options.seed = (unsigned long)value;
+    } else if (MatchNumber(arg, "--rate=", value, valid)) {
+      options.rate = value;
+      valid = valid && value > 0;
+    } else if (MatchNumber(arg, "--peak=", value, valid)) {
+      options.peak = value;
+      valid = valid && value >= 0;
+    } else if (MatchNumber(arg, "--city=", value, valid)) {
+      options.city = value;
+      valid = valid && value > 0;
+    } else if (MatchNumber(arg, "--hotspots=", value, valid)) {
+      options.hotspots = (int)value;
+      valid = valid && value >= 0;
+    } else if (MatchNumber(arg, "--hotspot-share=", value, valid)) {
+      options.hotspot_share = value;
+      valid = valid && value >= 0 && value <= 1;
+    } else if (MatchNumber(arg, "--hotspot-radius=", value, valid)) {
+      options.hotspot_radius = value;
+      valid = valid && value >= 0;
+    } else if (MatchNumber(arg, "--capacity=", value, valid)) {
+      options.params.capacity = (int)value;
+    } else if (MatchNumber(arg, "--speed=", value, valid)) {
+      options.params.speed = value;
+    } else if (MatchNumber(arg, "--max-wait=", value, valid)) {
+      options.params.max_wait_time = value;
+    } else if (MatchNumber(arg, "--max-delay=", value, valid)) {
+      options.params.max_delay = value;
+    } else if (MatchNumber(arg, "--max-distance=", value, valid)) {
+      options.params.max_distance = value;
+    } else if (MatchNumber(arg, "--min-efficiency=", value, valid)) {
+      options.params.min_efficiency = value;
+    } else {
+      valid = false;
+    }
+    if (!valid) {
+      std::fprintf(stderr, "invalid argument: %s\n", arg);
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Deterministic random numbers, independent of the standard library.
+ */
+class Random {
+private:
+  std::mt19937_64 engine_; // Fully specified by the standard.
+
+public:
+  explicit Random(unsigned long seed) : engine_(seed) {}
+
+  /**
+   * @brief Draws a uniform number in [0, 1).
+   */
+  double Uniform() { return (engine_() >> 11) * (1.0 / 9007199254740992.0); }
+
+  /**
+   * @brief Draws an exponential number of a given rate.
+   */
+  double Exponential(double rate) { return -std::log1p(-Uniform()) / rate; }
+
+  /**
+   * @brief Draws a standard normal number (Box-Muller).
+   */
+  double Normal() {
+    double radius = std::sqrt(-2.0 * std::log1p(-Uniform()));
+    return radius * std::cos(2.0 * kPi * Uniform());
+  }
+};
+
+/**
+ * @brief Arrival rate at a time of day, relative to the base rate.
+ *
+ * One plus `peak` times two Gaussian bumps of 90 time units centered at 8:00
+ * and 18:00. It never exceeds 1 + peak by more than a negligible overlap, so
+ * 1 + 1.01 * peak bounds it.
+ */
+double RelativeRate(double time, double peak) {
+  double hour = std::fmod(time, kDayLength);
+  double morning = (hour - 480) / 90;
+  double evening = (hour - 1080) / 90;
+  return 1.0 + peak * (std::exp(-0.5 * morning * morning) +
+                       std::exp(-0.5 * evening * evening));
+}
+
+/**
+ * @brief The hotspot mixture from which request endpoints are drawn.
+ */
+class PointSampler {
+private:
+  Vector<Point> centers_;     // Hotspot centers.
+  Vector<double> cumulative_; // Cumulative hotspot weights, ending at 1.
+  double city_;               // Side length of the city.
+  double share_;              // Probability of a hotspot point.
+  double radius_;             // Standard deviation around a hotspot.
+
+  double Clamp(double value) const {
+    return value < 0 ? 0 : (value > city_ ? city_ : value);
+  }
+
+  /**
+   * @brief Draws a point uniformly over the city, x first.
+   */
+  Point UniformPoint(Random &random) const {
+    double x = random.Uniform() * city_;
+    double y = random.Uniform() * city_;
+    return Point(x, y);
+  }
+
+public:
+  PointSampler(const WorkloadOptions &options, Random &random)
+      : city_(options.city), share_(options.hotspot_share),
+        radius_(options.hotspot_radius) {
+    double total = 0;
+    for (int k = 0; k < options.hotspots; ++k) {
+      centers_.push_back(UniformPoint(random));
+      total += 1.0 / (k + 1);
+      cumulative_.push_back(total);
+    }
+    for (size_t k = 0; k < cumulative_.size(); ++k) {
+      cumulative_[k] /= total;
+    }
+  }
+
+  Point Sample(Random &random) const {
+    if (centers_.empty() || random.Uniform() >= share_)
+      return UniformPoint(random);
+
+    // Binary search for the first cumulative weight above the draw.
+    double draw = random.Uniform();
+    size_t low = 0;
+    size_t high = cumulative_.size() - 1;
+    while (low < high) {
+      size_t middle = (low + high) / 2;
+      if (cumulative_[middle] > draw) {
+        high = middle;
+      } else {
+        low = middle + 1;
+      }
+    }
+    const Point &center = centers_[low];
+    // Drawn in sequence: the order of evaluation of arguments is unspecified.
+    double x = center.x + radius_ * random.Normal();
+    double y = center.y + radius_ * random.Normal();
+    return Point(Clamp(x), Clamp(y));
+  }
+};
+
+/**
+ * @brief Writes a parameter line in the shortest exact-enough form.
+ */
+void WriteParam(double value, OutputWriter &output) {
+  char text[32];
+  int length = std::snprintf(text, sizeof(text), "%.10g\n", value);
+  output.WriteString(text, (size_t)length);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  WorkloadOptions options;
+  options.requests = 1000000;
+  options.seed = 1;
+  options.rate = 5.0;
+  options.peak = 0.0;
+  options.city = 10000.0;
+  options.hotspots = 20;
+  options.hotspot_share = 0.7;
+  options.hotspot_radius = 200.0;
+  options.params.capacity = 4;
+  options.params.speed = 60.0;
+  options.params.max_wait_time = 30.0;
+  options.params.max_delay = 60.0;
+  options.params.max_distance = 500.0;
+  options.params.min_efficiency = 0.5;
+  if (!ParseArguments(argc, argv, options)) {
+    std::fprintf(stderr,
+                 "usage: %s [--requests=N] [--seed=S] [--rate=R] [--peak=A]"
+                 " [--city=L] [--hotspots=K] [--hotspot-share=P]"
+                 " [--hotspot-radius=D] [--capacity=C] [--speed=V]"
+                 " [--max-wait=W] [--max-delay=D] [--max-distance=D]"
+                 " [--min-efficiency=E]\n",
+                 argv[0]);
+    return 1;
+  }
+
+  OutputWriter output(1);
+  output.WriteInt(options.params.capacity);
+  output.WriteChar('\n');
+  WriteParam(options.params.speed, output);
+  WriteParam(options.params.max_wait_time, output);
+  WriteParam(options.params.max_delay, output);
+  WriteParam(options.params.max_distance, output);
+  WriteParam(options.params.min_efficiency, output);
+  output.WriteInt(options.requests);
+  output.WriteChar('\n');
+
+  Random random(options.seed);
+  PointSampler sampler(options, random);
+  double max_rate = options.rate * (1.0 + 1.01 * options.peak);
+  double time = 0;
+  for (long k = 0; k < options.requests; ++k) {
+    // Thinning: candidate arrivals at the maximum rate, each kept with
+    // probability rate(time) / max_rate.
+    do {
+      time += random.Exponential(max_rate);
+    } while (options.peak > 0 &&
+             random.Uniform() * (1.0 + 1.01 * options.peak) >
+                 RelativeRate(time, options.peak));
+
+    Point origin = sampler.Sample(random);
+    Point dest = sampler.Sample(random);
+    output.WriteInt(k);
+    output.WriteChar(' ');
+    output.WriteInt((long)time);
+    output.WriteChar(' ');
+    output.WriteFixed(origin.x, 5);
+    output.WriteChar(' ');
+    output.WriteFixed(origin.y, 5);
+    output.WriteChar(' ');
+    output.WriteFixed(dest.x, 5);
+    output.WriteChar(' ');
+    output.WriteFixed(dest.y, 5);
+    output.WriteChar('\n');
+  }
+  output.Flush();
+  return 0;
+}